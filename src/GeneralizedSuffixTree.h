@@ -0,0 +1,583 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_GENERALIZEDSUFFIXTREE_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_GENERALIZEDSUFFIXTREE_H
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+#include "TokenSuffixTree.h"
+
+// ======================= Suffix tree generalizado =======================
+// Suffix tree de una colección de documentos S_0, ..., S_{N-1}, construido como el TokenSuffixTree de
+// S_0 #_0 S_1 #_1 ... S_{N-1} #_{N-1}, donde cada byte es un token (0..255) y cada separador #_d es
+// un token distinto (SEPARATOR_BASE + d). Como los separadores son únicos:
+//  - ningún nodo interno (salvo la raíz) tiene un separador en su path label, por lo que cada nodo
+//    interno representa un substring común a las hojas de su subárbol;
+//  - label(v) es sufijo de S_d exactamente cuando v tiene un hijo cuya arista empieza con #_d.
+
+const Token SEPARATOR_BASE = 256;
+
+// Con hasta DENSE_DOCUMENT_LIMIT documentos, los conjuntos de documentos por nodo son bitsets exactos.
+const int DENSE_DOCUMENT_LIMIT = 512;
+
+// Substring común: 'length' tokens a partir de 'offset' dentro del documento 'document'.
+struct CommonSubstring {
+    int length;
+    int document;
+    int offset;
+};
+
+// Resultado de GeneralizedSuffixTree::crossParsingSimilarity().
+struct SimilarityReport {
+    vector<vector<int> > phrases; // phrases[i][j] = c(S_i | S_j), frases del cross-parsing de S_i respecto a S_j
+    vector<vector<double> > score; // score[i][j] = |S_i| / c(S_i | S_j), longitud media de frase (mayor = más similar)
+    double seconds; // Tiempo de cálculo de la matriz
+    double pairsPerSecond; // Pares de documentos procesados por segundo
+};
+
+// Conjunto de documentos de un nodo durante GeneralizedSuffixTree::forEachDocumentSet(): un bitset
+// (colecciones chicas) o el conjunto mezclado del subárbol (colecciones grandes).
+struct DocumentSetView {
+    const uint64_t *bits; // nullptr si el conjunto es disperso
+    int words;
+    const unordered_set<int> *documents; // nullptr si el conjunto es un bitset
+    int size; // Número de documentos distintos
+
+    // Documentos del conjunto en orden creciente.
+    vector<int> members() const {
+        vector<int> result;
+        if (bits != nullptr) {
+            for (int w = 0; w < words; w++) {
+                for (uint64_t word = bits[w]; word != 0; word &= word - 1)
+                    result.push_back(w * 64 + __builtin_ctzll(word));
+            }
+        } else {
+            result.assign(documents->begin(), documents->end());
+            sort(result.begin(), result.end());
+        }
+        return result;
+    }
+};
+
+// Resumen de GeneralizedSuffixTree::findNearDuplicates().
+struct NearDuplicateSummary {
+    long long repeats; // Repeticiones maximales reportadas
+    int clusters; // Grupos de al menos dos documentos
+    double seconds;
+};
+
+class GeneralizedSuffixTree {
+private:
+    vector<int> docStart; // Posición de S_d en el texto concatenado
+    vector<int> docLength; // |S_d| (sin el separador)
+    TokenSuffixTree tree;
+    int setWords; // Palabras de 64 bits por conjunto de documentos (0 = no construidos)
+    vector<uint64_t> documentSets; // Conjunto de documentos de cada nodo: setWords palabras por id de nodo
+    vector<int> leafBegin; // Colecciones grandes: rango de la primera hoja del subárbol de cada id (preorden)
+    vector<int> documentLeafStart; // documentLeaves[documentLeafStart[d]..documentLeafStart[d + 1]) son de S_d
+    vector<int> documentLeaves; // Rangos (en preorden) de las hojas de cada documento, ordenados
+
+    static vector<Token> concatenate(const vector<string> &documents) {
+        vector<Token> tokens;
+        for (size_t d = 0; d < documents.size(); d++) {
+            for (unsigned char c: documents[d])
+                tokens.push_back(c);
+            tokens.push_back(SEPARATOR_BASE + static_cast<Token>(d));
+        }
+        return tokens;
+    }
+
+public:
+    explicit GeneralizedSuffixTree(const vector<string> &documents) : tree(concatenate(documents)), setWords(0) {
+        int position = 0;
+        for (const string &document: documents) {
+            docStart.push_back(position);
+            docLength.push_back(static_cast<int>(document.size()));
+            position += static_cast<int>(document.size()) + 1;
+        }
+    }
+
+    int documentCount() const {
+        return static_cast<int>(docStart.size());
+    }
+
+    int documentStart(int d) const {
+        return docStart[d];
+    }
+
+    int documentLength(int d) const {
+        return docLength[d];
+    }
+
+    // Documento al que pertenece una posición del texto concatenado (el separador #_d pertenece a S_d);
+    // -1 para el TERMINAL_TOKEN final.
+    int documentOf(int position) const {
+        int d = static_cast<int>(upper_bound(docStart.begin(), docStart.end(), position) - docStart.begin()) - 1;
+        if (d < 0 || position > docStart[d] + docLength[d])
+            return -1;
+        return d;
+    }
+
+    static bool isSeparator(Token token) {
+        return token >= SEPARATOR_BASE && token != TERMINAL_TOKEN;
+    }
+
+    const TokenSuffixTree &getTree() const {
+        return tree;
+    }
+
+    // ======================= [EXTRA] All-pairs suffix-prefix (Gusfield) =======================
+    // Para cada par ordenado (i, j), reporta emit(i, j, len) con len = longitud del sufijo más largo de
+    // S_i que es prefijo de S_j, si len ≥ minLength (para i == j no se reporta el solapamiento trivial
+    // de S_i consigo mismo). Una sola DFS: al entrar a un nodo v con un hijo #_i, label(v) es sufijo de
+    // S_i y se apila stringDepth(v) en la pila de i; al llegar a la hoja del sufijo que empieza en S_j,
+    // el tope de cada pila es el solapamiento más largo. Costo: O(longitud total + N²).
+    void allPairsSuffixPrefix(int minLength, const function<void(int, int, int)> &emit) const {
+        minLength = max(minLength, 1);
+        const int documents = documentCount();
+        const vector<Token> &tokens = tree.getTokens();
+        vector<vector<int> > overlapStacks(documents);
+        vector<int> startOf(tokens.size(), -1); // Documento cuyo inicio es cada posición
+        for (int d = 0; d < documents; d++)
+            startOf[docStart[d]] = d;
+
+        // Pila de la DFS: (nodo, saliendo). Al salir se desapilan las entradas que apiló el nodo.
+        vector<pair<const TokenNode *, bool> > stack = {{tree.getRoot(), false}};
+        while (!stack.empty()) {
+            const TokenNode *node = stack.back().first;
+            const bool exiting = stack.back().second;
+            stack.pop_back();
+            const auto separators = node->children.lower_bound(SEPARATOR_BASE);
+            if (exiting) {
+                if (node->stringDepth == 0)
+                    continue;
+                for (auto it = separators; it != node->children.end() && it->first != TERMINAL_TOKEN; ++it)
+                    overlapStacks[it->first - SEPARATOR_BASE].pop_back();
+                continue;
+            }
+            if (node->isLeaf()) {
+                int j = startOf[node->suffixIndex];
+                if (j < 0)
+                    continue;
+                for (int i = 0; i < documents; i++) {
+                    const vector<int> &candidates = overlapStacks[i];
+                    int k = static_cast<int>(candidates.size()) - 1;
+                    if (i == j && k >= 0 && candidates[k] == docLength[j])
+                        k--; // Solapamiento trivial de S_j consigo mismo
+                    if (k >= 0 && candidates[k] >= minLength)
+                        emit(i, j, candidates[k]);
+                }
+                continue;
+            }
+            if (node->stringDepth > 0) {
+                for (auto it = separators; it != node->children.end() && it->first != TERMINAL_TOKEN; ++it)
+                    overlapStacks[it->first - SEPARATOR_BASE].push_back(node->stringDepth);
+            }
+            stack.push_back({node, true});
+            for (const auto &entry: node->children)
+                stack.push_back({entry.second, false});
+        }
+    }
+
+    // ======================= [EXTRA] Substring común a al menos k documentos (Hui) =======================
+    // result[k] (2 ≤ k ≤ N) es el substring más largo que aparece en al menos k documentos distintos
+    // (length = 0 si no hay). En una sola DFS se calcula para cada nodo el número de documentos
+    // distintos en su subárbol: hojas del subárbol menos una corrección -1 en el LCA de cada par de
+    // hojas consecutivas (en orden DFS) del mismo documento. Los LCA se obtienen fuera de línea con el
+    // algoritmo de Tarjan (union-find) durante el mismo recorrido. Costo: O(n · α(n) + N).
+    vector<CommonSubstring> longestCommonSubstrings() const {
+        const int documents = documentCount();
+        const vector<TokenNode *> &nodes = tree.getNodes();
+        const int nodeCount = static_cast<int>(nodes.size());
+        vector<int> setParent(nodeCount), setAncestor(nodeCount), distinct(nodeCount, 0);
+        vector<int> lastLeaf(documents, -1);
+        auto find = [&setParent](int x) {
+            while (setParent[x] != x) {
+                setParent[x] = setParent[setParent[x]];
+                x = setParent[x];
+            }
+            return x;
+        };
+
+        vector<pair<const TokenNode *, bool> > stack = {{tree.getRoot(), false}};
+        while (!stack.empty()) {
+            const TokenNode *node = stack.back().first;
+            const bool exiting = stack.back().second;
+            stack.pop_back();
+            const int v = node->id;
+            if (!exiting) {
+                setParent[v] = v;
+                setAncestor[v] = v;
+                if (node->isLeaf()) {
+                    int d = documentOf(node->suffixIndex);
+                    if (d >= 0) {
+                        distinct[v] = 1;
+                        if (lastLeaf[d] >= 0)
+                            distinct[setAncestor[find(lastLeaf[d])]]--; // LCA con la hoja anterior de d
+                        lastLeaf[d] = v;
+                    }
+                }
+                stack.push_back({node, true});
+                for (auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+                    stack.push_back({it->second, false});
+                continue;
+            }
+            // Al terminar 'node': acumula en el padre y lo une a su conjunto (Tarjan).
+            if (node->parent != nullptr) {
+                const int p = node->parent->id;
+                distinct[p] += distinct[v];
+                setParent[find(v)] = find(p);
+                setAncestor[find(p)] = p;
+            }
+        }
+
+        // best[c]: nodo interno más profundo con exactamente c documentos distintos.
+        vector<const TokenNode *> best(documents + 1, nullptr);
+        for (const TokenNode *node: nodes) {
+            if (node->isLeaf() || node->stringDepth == 0)
+                continue;
+            int c = min(distinct[node->id], documents);
+            if (best[c] == nullptr || node->stringDepth > best[c]->stringDepth)
+                best[c] = node;
+        }
+        vector<CommonSubstring> result(documents + 1, {0, -1, -1});
+        const TokenNode *running = nullptr;
+        for (int k = documents; k >= 2; k--) {
+            if (best[k] != nullptr && (running == nullptr || best[k]->stringDepth > running->stringDepth))
+                running = best[k];
+            if (running != nullptr) {
+                int position = tree.labelStart(running);
+                int d = documentOf(position);
+                result[k] = {running->stringDepth, d, position - docStart[d]};
+            }
+        }
+        return result;
+    }
+
+    // ======================= [EXTRA] Conjuntos de documentos por nodo =======================
+    // Documentos que tienen una hoja en el subárbol de cada nodo (es decir, los documentos donde aparece
+    // label(v) y todo prefijo que termina en la arista de v). Con N ≤ DENSE_DOCUMENT_LIMIT se guarda un
+    // bitset de N bits por nodo (nodos × ⌈N / 64⌉ palabras). Con más documentos ese bitset no escala, así
+    // que se guardan solo los rangos en preorden de las hojas de cada documento (O(n) enteros): el
+    // subárbol de v ocupa el rango [leafBegin(v), leafBegin(v) + leafCount) y containsDocument() busca
+    // en él una hoja del documento en O(log n).
+    void buildDocumentSets() {
+        if (setWords > 0 || !leafBegin.empty())
+            return;
+        if (documentCount() <= DENSE_DOCUMENT_LIMIT) {
+            forEachDocumentSet([](const TokenNode *, const DocumentSetView &) {});
+            return;
+        }
+        const vector<TokenNode *> &nodes = tree.getNodes();
+        leafBegin.assign(nodes.size(), 0);
+        vector<int> leafDocument;
+        for (const TokenNode *node: nodes) {
+            leafBegin[node->id] = static_cast<int>(leafDocument.size());
+            if (node->isLeaf())
+                leafDocument.push_back(documentOf(node->suffixIndex));
+        }
+        documentLeafStart.assign(documentCount() + 1, 0);
+        for (int d: leafDocument) {
+            if (d >= 0)
+                documentLeafStart[d + 1]++;
+        }
+        for (int d = 0; d < documentCount(); d++)
+            documentLeafStart[d + 1] += documentLeafStart[d];
+        documentLeaves.resize(documentLeafStart.back());
+        vector<int> fill(documentLeafStart.begin(), documentLeafStart.end() - 1);
+        for (int rank = 0; rank < static_cast<int>(leafDocument.size()); rank++) {
+            if (leafDocument[rank] >= 0)
+                documentLeaves[fill[leafDocument[rank]]++] = rank;
+        }
+    }
+
+    // Recorre los nodos de abajo hacia arriba (preorden inverso: cada nodo después de sus hijos) y llama a
+    // visit(node, set) cuando el conjunto de 'node' está completo.
+    //  - N ≤ DENSE_DOCUMENT_LIMIT: bitsets (se calculan en el primer recorrido y se conservan).
+    //  - N mayor: mezcla small-to-large, donde cada nodo hereda el conjunto más grande de sus hijos e
+    //    inserta los demás. Cada documento se reinserta O(log n) veces y solo viven los conjuntos de
+    //    los nodos cuyo padre no se ha visitado (O(n) elementos). 'set' es válido solo durante visit.
+    template<typename Visitor>
+    void forEachDocumentSet(Visitor visit) {
+        const vector<TokenNode *> &nodes = tree.getNodes();
+        if (documentCount() <= DENSE_DOCUMENT_LIMIT) {
+            const bool built = setWords > 0;
+            if (!built) {
+                setWords = max(1, (documentCount() + 63) / 64);
+                documentSets.assign(nodes.size() * setWords, 0);
+            }
+            for (size_t k = nodes.size(); k-- > 0;) {
+                const TokenNode *node = nodes[k];
+                uint64_t *set = &documentSets[node->id * static_cast<size_t>(setWords)];
+                if (!built && node->isLeaf()) {
+                    int d = documentOf(node->suffixIndex);
+                    if (d >= 0)
+                        set[d / 64] |= uint64_t(1) << (d % 64);
+                }
+                int size = 0;
+                for (int w = 0; w < setWords; w++)
+                    size += __builtin_popcountll(set[w]);
+                visit(node, DocumentSetView{set, setWords, nullptr, size});
+                if (!built && node->parent != nullptr) {
+                    uint64_t *parentSet = &documentSets[node->parent->id * static_cast<size_t>(setWords)];
+                    for (int w = 0; w < setWords; w++)
+                        parentSet[w] |= set[w];
+                }
+            }
+            return;
+        }
+
+        vector<unordered_set<int> > pool; // Conjuntos vivos
+        vector<int> freeSlots;
+        vector<int> slot(nodes.size(), -1); // Conjunto de cada id en 'pool' (-1 = vacío)
+        for (size_t k = nodes.size(); k-- > 0;) {
+            const TokenNode *node = nodes[k];
+            int s = slot[node->id];
+            if (s < 0) {
+                if (freeSlots.empty()) {
+                    s = static_cast<int>(pool.size());
+                    pool.emplace_back();
+                } else {
+                    s = freeSlots.back();
+                    freeSlots.pop_back();
+                }
+            }
+            if (node->isLeaf()) {
+                int d = documentOf(node->suffixIndex);
+                if (d >= 0)
+                    pool[s].insert(d);
+            }
+            visit(node, DocumentSetView{nullptr, 0, &pool[s], static_cast<int>(pool[s].size())});
+            int &parentSlot = node->parent != nullptr ? slot[node->parent->id] : s;
+            if (node->parent != nullptr && parentSlot < 0) {
+                parentSlot = s; // El padre hereda el conjunto
+                continue;
+            }
+            if (node->parent != nullptr) {
+                unordered_set<int> &target = pool[parentSlot];
+                if (target.size() < pool[s].size())
+                    target.swap(pool[s]);
+                target.insert(pool[s].begin(), pool[s].end());
+            }
+            unordered_set<int>().swap(pool[s]); // clear() recorrería todas las cubetas al reusar el conjunto
+            freeSlots.push_back(s);
+        }
+    }
+
+    bool containsDocument(const TokenNode *node, int d) const {
+        if (setWords > 0)
+            return (documentSets[node->id * static_cast<size_t>(setWords) + d / 64] >> (d % 64)) & 1;
+        const int begin = leafBegin[node->id];
+        auto first = documentLeaves.begin() + documentLeafStart[d], last = documentLeaves.begin() + documentLeafStart[d + 1];
+        auto it = lower_bound(first, last, begin);
+        return it != last && *it < begin + node->leafCount;
+    }
+
+    // ======================= [EXTRA] Similitud por cross-parsing (Ziv–Merhav) =======================
+    // Número de frases c(S_i | S_j) del cross-parsing de S_i respecto a S_j: S_i se parte de izquierda a
+    // derecha en la frase más larga que aparece en S_j (o un token suelto si ninguna aparece).
+    // Cada frase desciende desde la raíz solo por nodos cuyo conjunto contiene a j, así que el costo
+    // es O(|S_i| · log Σ) por par, sin construir un árbol por documento.
+    int crossParse(int i, int j) {
+        buildDocumentSets();
+        const vector<Token> &tokens = tree.getTokens();
+        const int end = docStart[i] + docLength[i];
+        int phrases = 0;
+        for (int pos = docStart[i]; pos < end;) {
+            const TokenNode *node = tree.getRoot();
+            int matched = 0;
+            while (pos + matched < end) {
+                const TokenNode *child = node->child(tokens[pos + matched]);
+                if (child == nullptr || !containsDocument(child, j))
+                    break;
+                const int length = child->edgeLength();
+                int k = 0;
+                while (k < length && pos + matched < end && tokens[child->start + k] == tokens[pos + matched]) {
+                    k++;
+                    matched++;
+                }
+                if (k < length)
+                    break;
+                node = child;
+            }
+            phrases++;
+            pos += max(matched, 1);
+        }
+        return phrases;
+    }
+
+    // [EXTRA] Matriz N × N de cross-parsing en paralelo (filas repartidas entre los hilos; el árbol y los
+    // conjuntos de documentos son de solo lectura durante el cálculo). 'threads' = 0 usa todos los núcleos.
+    SimilarityReport crossParsingSimilarity(unsigned threads = 0) {
+        buildDocumentSets();
+        const int documents = documentCount();
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        SimilarityReport report;
+        report.phrases.assign(documents, vector<int>(documents, 0));
+        report.score.assign(documents, vector<double>(documents, 0.0));
+        auto begin = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([this, t, threads, documents, &report]() {
+                for (int i = static_cast<int>(t); i < documents; i += static_cast<int>(threads)) {
+                    for (int j = 0; j < documents; j++) {
+                        int phrases = crossParse(i, j);
+                        report.phrases[i][j] = phrases;
+                        report.score[i][j] = phrases > 0 ? static_cast<double>(docLength[i]) / phrases : 0.0;
+                    }
+                }
+            });
+        }
+        for (thread &worker: workers)
+            worker.join();
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        report.pairsPerSecond = report.seconds > 0 ? static_cast<double>(documents) * documents / report.seconds : 0.0;
+        return report;
+    }
+
+    // ======================= [EXTRA] Detección de regiones casi duplicadas =======================
+    // Lee los archivos de 'paths' (binarios) en 'documents'. Retorna false si alguno no se pudo leer.
+    static bool readDocuments(const vector<string> &paths, vector<string> &documents) {
+        documents.clear();
+        for (const string &path: paths) {
+            ifstream in(path, ios::binary);
+            if (!in)
+                return false;
+            documents.emplace_back((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        }
+        return true;
+    }
+
+    // [EXTRA] Reporta, en un solo recorrido de abajo hacia arriba, las repeticiones maximales de longitud
+    // ≥ minLength compartidas por al menos dos documentos, y agrupa los documentos que comparten alguna.
+    // Un nodo interno v se reporta si:
+    //  - es maximal a la izquierda: sus ocurrencias no tienen todas el mismo token anterior (o alguna
+    //    empieza un documento);
+    //  - es maximal para su conjunto de documentos: ningún hijo aparece exactamente en los mismos
+    //    documentos (si no, la extensión más larga del hijo lo cubre).
+    // Cada repetición se escribe en 'out' en cuanto se encuentra, como una línea JSON
+    // {"type":"repeat",...}; al final se escribe una línea {"type":"cluster",...} por grupo (componentes
+    // conexas de documentos). sharedBytes estima los bytes redundantes del grupo como la suma de
+    // longitud × (ocurrencias - 1) de sus repeticiones (cota superior: repeticiones anidadas de
+    // distintos conjuntos de documentos se cuentan por separado).
+    NearDuplicateSummary findNearDuplicates(int minLength, ostream &out) {
+        auto begin = chrono::steady_clock::now();
+        const int documents = documentCount();
+        const vector<Token> &tokens = tree.getTokens();
+        const int DIVERSE = -1;
+        vector<int64_t> leftToken(tree.getNodes().size(), DIVERSE); // Token anterior común, o DIVERSE
+        vector<int> cluster(documents);
+        for (int d = 0; d < documents; d++)
+            cluster[d] = d;
+        auto find = [&cluster](int x) {
+            while (cluster[x] != x) {
+                cluster[x] = cluster[cluster[x]];
+                x = cluster[x];
+            }
+            return x;
+        };
+        vector<pair<int, long long> > contributions; // (documento, bytes redundantes) por repetición
+        vector<int> documentTotal(tree.getNodes().size(), 0); // Documentos distintos de cada nodo visitado
+        NearDuplicateSummary summary{0, 0, 0.0};
+
+        forEachDocumentSet([&](const TokenNode *node, const DocumentSetView &set) {
+            const int v = node->id;
+            documentTotal[v] = set.size;
+            if (node->isLeaf()) {
+                int p = node->suffixIndex;
+                leftToken[v] = p > 0 && !isSeparator(tokens[p - 1]) ? static_cast<int64_t>(tokens[p - 1]) : DIVERSE;
+                return;
+            }
+            // El conjunto de un hijo está contenido en el del padre: son iguales si tienen el mismo tamaño.
+            bool sameAsChild = false;
+            int64_t left = -2; // Sin hijos vistos aún
+            for (const auto &entry: node->children) {
+                const TokenNode *child = entry.second;
+                const int64_t childLeft = leftToken[child->id];
+                left = left == -2 || left == childLeft ? childLeft : DIVERSE;
+                sameAsChild = sameAsChild || documentTotal[child->id] == set.size;
+            }
+            leftToken[v] = left;
+            if (node->stringDepth < max(minLength, 1) || left != DIVERSE || sameAsChild || set.size < 2)
+                return;
+            const vector<int> members = set.members();
+            const int position = tree.labelStart(node);
+            const int d = documentOf(position);
+            out << "{\"type\":\"repeat\",\"length\":" << node->stringDepth << ",\"occurrences\":"
+                << node->leafCount << ",\"document\":" << d << ",\"offset\":" << position - docStart[d]
+                << ",\"documents\":[";
+            for (size_t k = 0; k < members.size(); k++) {
+                out << (k > 0 ? "," : "") << members[k];
+                cluster[find(members[k])] = find(members[0]);
+            }
+            out << "]}\n";
+            contributions.push_back({members[0], static_cast<long long>(node->stringDepth) * (node->leafCount - 1)});
+            summary.repeats++;
+        });
+
+        // Resumen por grupo: documentos, repeticiones, bytes totales y bytes redundantes estimados.
+        vector<vector<int> > members(documents);
+        for (int d = 0; d < documents; d++)
+            members[find(d)].push_back(d);
+        vector<long long> sharedBytes(documents, 0), repeats(documents, 0);
+        for (const auto &contribution: contributions) {
+            sharedBytes[find(contribution.first)] += contribution.second;
+            repeats[find(contribution.first)]++;
+        }
+        for (int root = 0; root < documents; root++) {
+            if (members[root].size() < 2)
+                continue;
+            long long totalBytes = 0;
+            out << "{\"type\":\"cluster\",\"id\":" << summary.clusters << ",\"documents\":[";
+            for (size_t k = 0; k < members[root].size(); k++) {
+                out << (k > 0 ? "," : "") << members[root][k];
+                totalBytes += docLength[members[root][k]];
+            }
+            out << "],\"repeats\":" << repeats[root] << ",\"totalBytes\":" << totalBytes
+                << ",\"sharedBytes\":" << sharedBytes[root] << "}\n";
+            summary.clusters++;
+        }
+        out.flush();
+        summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        return summary;
+    }
+
+    // [EXTRA] Pipeline completo: lee los archivos, construye el árbol generalizado y escribe el reporte
+    // en 'reportPath'. Retorna false si algún archivo no se pudo leer o el reporte no se pudo escribir.
+    static bool detectNearDuplicates(const vector<string> &paths, int minLength, const string &reportPath,
+                                     NearDuplicateSummary *summary = nullptr) {
+        vector<string> documents;
+        if (!readDocuments(paths, documents))
+            return false;
+        ofstream out(reportPath);
+        if (!out)
+            return false;
+        GeneralizedSuffixTree tree(documents);
+        NearDuplicateSummary result = tree.findNearDuplicates(minLength, out);
+        if (summary != nullptr)
+            *summary = result;
+        return static_cast<bool>(out);
+    }
+
+    // [EXTRA] Los k documentos más similares a cada documento según report.score (sin incluirse a sí mismo),
+    // como pares (documento, score) en orden decreciente.
+    static vector<vector<pair<int, double> > > topKSimilar(const SimilarityReport &report, int k) {
+        const int documents = static_cast<int>(report.score.size());
+        vector<vector<pair<int, double> > > result(documents);
+        for (int i = 0; i < documents; i++) {
+            for (int j = 0; j < documents; j++) {
+                if (j != i)
+                    result[i].push_back({j, report.score[i][j]});
+            }
+            const int keep = min(max(k, 0), static_cast<int>(result[i].size()));
+            partial_sort(result[i].begin(), result[i].begin() + keep, result[i].end(),
+                         [](const pair<int, double> &a, const pair<int, double> &b) { return a.second > b.second; });
+            result[i].resize(keep);
+        }
+        return result;
+    }
+};
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_GENERALIZEDSUFFIXTREE_H
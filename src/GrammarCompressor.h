@@ -0,0 +1,465 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_GRAMMARCOMPRESSOR_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_GRAMMARCOMPRESSOR_H
+
+#include <chrono>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <random>
+#include "TokenSuffixTree.h"
+
+// ======================= Compresión por gramáticas (repeticiones maximales) =======================
+// Compresor que reemplaza repetidamente las repeticiones más rentables por no terminales, usando el
+// TokenSuffixTree de la secuencia actual: cada nodo interno es una repetición (right-maximal) de
+// longitud stringDepth con leafCount ocurrencias. El resultado es un straight-line program (SLP):
+// reglas binarias X -> Y Z más una secuencia inicial, con acceso aleatorio sin descomprimir.
+
+// Los símbolos 0..255 son bytes; el no terminal r se representa con NONTERMINAL_BASE + r.
+const Token NONTERMINAL_BASE = 256;
+
+// ======================= Straight-line program =======================
+class StraightLineProgram {
+private:
+    vector<pair<Token, Token> > rules; // rules[r] = (izquierdo, derecho) del no terminal NONTERMINAL_BASE + r
+    vector<long long> ruleLength; // Longitud de la expansión de cada regla
+    vector<Token> sequence; // Secuencia inicial (terminales y no terminales)
+    vector<long long> prefix; // prefix[k] = longitud expandida de sequence[0..k)
+
+    long long lengthOf(Token symbol) const {
+        return symbol < NONTERMINAL_BASE ? 1 : ruleLength[symbol - NONTERMINAL_BASE];
+    }
+
+    // Agrega a 'out' los caracteres [from, to) de la expansión de 'symbol' (DFS iterativa que descarta
+    // los subárboles fuera del rango).
+    void expand(Token symbol, long long from, long long to, string &out) const {
+        vector<pair<Token, long long> > stack = {{symbol, 0}}; // (símbolo, offset de su expansión)
+        while (!stack.empty()) {
+            Token current = stack.back().first;
+            long long offset = stack.back().second;
+            stack.pop_back();
+            long long length = lengthOf(current);
+            if (offset + length <= from || offset >= to)
+                continue;
+            if (current < NONTERMINAL_BASE) {
+                out.push_back(static_cast<char>(current));
+                continue;
+            }
+            const pair<Token, Token> &rule = rules[current - NONTERMINAL_BASE];
+            stack.push_back({rule.second, offset + lengthOf(rule.first)});
+            stack.push_back({rule.first, offset});
+        }
+    }
+
+public:
+    StraightLineProgram() : prefix(1, 0) {
+    }
+
+    // Agrega la regla X -> left right y retorna X.
+    Token addRule(Token left, Token right) {
+        rules.push_back({left, right});
+        ruleLength.push_back(lengthOf(left) + lengthOf(right));
+        return NONTERMINAL_BASE + static_cast<Token>(rules.size() - 1);
+    }
+
+    void append(Token symbol) {
+        sequence.push_back(symbol);
+        prefix.push_back(prefix.back() + lengthOf(symbol));
+    }
+
+    // Longitud del texto original.
+    long long length() const {
+        return prefix.back();
+    }
+
+    int ruleCount() const {
+        return static_cast<int>(rules.size());
+    }
+
+    int sequenceLength() const {
+        return static_cast<int>(sequence.size());
+    }
+
+    // Tamaño de la gramática en símbolos: 2 por regla más la secuencia inicial.
+    long long grammarSize() const {
+        return 2LL * static_cast<long long>(rules.size()) + static_cast<long long>(sequence.size());
+    }
+
+    // [EXTRA] Carácter en la posición i del texto original: búsqueda binaria en la secuencia inicial y
+    // descenso por las reglas en O(log |secuencia| + altura).
+    char access(long long i) const {
+        size_t k = upper_bound(prefix.begin(), prefix.end(), i) - prefix.begin() - 1;
+        Token symbol = sequence[k];
+        i -= prefix[k];
+        while (symbol >= NONTERMINAL_BASE) {
+            const pair<Token, Token> &rule = rules[symbol - NONTERMINAL_BASE];
+            long long left = lengthOf(rule.first);
+            if (i < left) {
+                symbol = rule.first;
+            } else {
+                symbol = rule.second;
+                i -= left;
+            }
+        }
+        return static_cast<char>(symbol);
+    }
+
+    // [EXTRA] Substring [position, position + count) del texto original sin descomprimir el resto.
+    string extract(long long position, long long count) const {
+        string out;
+        long long to = min(position + count, length());
+        if (position >= to)
+            return out;
+        size_t k = upper_bound(prefix.begin(), prefix.end(), position) - prefix.begin() - 1;
+        for (; k < sequence.size() && prefix[k] < to; k++)
+            expand(sequence[k], position - prefix[k], to - prefix[k], out);
+        return out;
+    }
+
+    // Texto original completo.
+    string decode() const {
+        return extract(0, length());
+    }
+
+    // ======================= Formato de archivo =======================
+    // Número de reglas y longitud de la secuencia (enteros de 32 bits en el orden de bytes del host),
+    // seguidos de los pares de las reglas y la secuencia inicial empaquetados en bits: cada símbolo usa
+    // symbolBits() bits (los justos para 256 + número de reglas valores), del bit menos significativo
+    // de cada byte al más significativo.
+    static int symbolBits(long long ruleTotal) {
+        int bits = 8;
+        while ((1LL << bits) < NONTERMINAL_BASE + ruleTotal)
+            bits++;
+        return bits;
+    }
+
+    void write(ostream &out) const {
+        auto put = [&out](uint32_t value) {
+            out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        };
+        put(static_cast<uint32_t>(rules.size()));
+        put(static_cast<uint32_t>(sequence.size()));
+        const int bits = symbolBits(static_cast<long long>(rules.size()));
+        uint64_t buffer = 0;
+        int buffered = 0;
+        auto pack = [&](Token symbol) {
+            buffer |= static_cast<uint64_t>(symbol) << buffered;
+            buffered += bits;
+            while (buffered >= 8) {
+                out.put(static_cast<char>(buffer & 0xFF));
+                buffer >>= 8;
+                buffered -= 8;
+            }
+        };
+        for (const auto &rule: rules) {
+            pack(rule.first);
+            pack(rule.second);
+        }
+        for (Token symbol: sequence)
+            pack(symbol);
+        if (buffered > 0)
+            out.put(static_cast<char>(buffer & 0xFF));
+    }
+
+    // Bytes que ocupa write().
+    long long serializedSize() const {
+        return static_cast<long long>(2 * sizeof(uint32_t)) +
+               (grammarSize() * symbolBits(static_cast<long long>(rules.size())) + 7) / 8;
+    }
+
+    // Lee un SLP escrito con write(). Si el archivo está truncado o una regla usa un no terminal que aún
+    // no existe, la lectura se detiene y 'in' queda en estado de error.
+    static StraightLineProgram read(istream &in) {
+        auto get = [&in]() {
+            uint32_t value = 0;
+            in.read(reinterpret_cast<char *>(&value), sizeof(value));
+            return value;
+        };
+        StraightLineProgram program;
+        uint32_t ruleTotal = get();
+        uint32_t sequenceTotal = get();
+        const int bits = symbolBits(ruleTotal);
+        uint64_t buffer = 0;
+        int buffered = 0;
+        auto unpack = [&](uint32_t limit) {
+            while (buffered < bits) {
+                int byte = in.get();
+                if (byte == EOF)
+                    return limit; // Fuera de rango: marca el error
+                buffer |= static_cast<uint64_t>(byte) << buffered;
+                buffered += 8;
+            }
+            Token symbol = static_cast<Token>(buffer & ((uint64_t(1) << bits) - 1));
+            buffer >>= bits;
+            buffered -= bits;
+            return symbol;
+        };
+        for (uint32_t r = 0; r < ruleTotal && in; r++) {
+            const uint32_t limit = NONTERMINAL_BASE + r; // Solo reglas anteriores
+            Token left = unpack(limit);
+            Token right = unpack(limit);
+            if (left >= limit || right >= limit) {
+                in.setstate(ios::failbit);
+                break;
+            }
+            program.addRule(left, right);
+        }
+        for (uint32_t k = 0; k < sequenceTotal && in; k++) {
+            const uint32_t limit = NONTERMINAL_BASE + static_cast<uint32_t>(program.ruleCount());
+            Token symbol = unpack(limit);
+            if (symbol >= limit) {
+                in.setstate(ios::failbit);
+                break;
+            }
+            program.append(symbol);
+        }
+        return program;
+    }
+};
+
+// Resultado de GrammarCompressor::benchmark().
+struct CompressionReport {
+    long long originalBytes;
+    long long compressedBytes; // serializedSize() del SLP
+    double ratio; // originalBytes / compressedBytes
+    int rounds; // Rondas de reemplazo (árboles construidos)
+    int rules; // Reglas binarias del SLP
+    double compressSeconds;
+    double decodeSeconds; // Descompresión completa
+    double compressMBps; // Velocidad de compresión (MB/s del texto original)
+    double decodeMBps;
+    double accessNanos; // Tiempo promedio de un access(i) aleatorio
+    bool roundTrip; // decode() reproduce el texto (si es false, ratio no es válida)
+};
+
+// ======================= Compresor =======================
+class GrammarCompressor {
+private:
+    // Candidato de una ronda: nodo interno con la ganancia estimada (en bits) de reemplazar todas sus
+    // ocurrencias.
+    struct Candidate {
+        TokenNode *node;
+        double gain;
+    };
+
+    // Modelo de costo en bits del formato de write(): cada símbolo ocupa ~log2(256 + reglas binarias)
+    // bits. Reemplazar c ocurrencias de longitud L ahorra c·(L - 1) símbolos; la regla plana se binariza
+    // en hasta L - 1 reglas binarias (2·(L - 1) símbolos) y cada regla nueva ensancha los símbolos de
+    // toda la gramática en ~1 / ((256 + reglas)·ln 2) bits.
+    struct GainModel {
+        long long binaryRules; // Estimación de reglas binarias tras binarizar las reglas planas
+        long long grammarSymbols; // Estimación de símbolos serializados (secuencia + 2 por regla binaria)
+
+        double gain(long long count, long long length) const {
+            const double alphabet = static_cast<double>(NONTERMINAL_BASE + binaryRules);
+            const double symbolBits = log2(alphabet);
+            const double widening = static_cast<double>(grammarSymbols) / (alphabet * log(2.0));
+            return static_cast<double>(length - 1) * ((count - 2) * symbolBits - widening);
+        }
+
+        void apply(long long count, long long length) {
+            binaryRules += length - 1;
+            grammarSymbols += 2 * (length - 1) - count * (length - 1);
+        }
+    };
+
+    // Una ronda: elige repeticiones de mayor a menor ganancia estimada, toma de cada una un conjunto
+    // de ocurrencias que no se solapen con otras ya reemplazadas y crea la regla plana si la ganancia
+    // real es positiva. Retorna false si no se creó ninguna regla.
+    static bool replaceRound(vector<Token> &sequence, vector<vector<Token> > &flatRules, int minLength) {
+        const int n = static_cast<int>(sequence.size());
+        GainModel model{0, n};
+        for (const vector<Token> &rule: flatRules)
+            model.binaryRules += static_cast<long long>(rule.size()) - 1;
+        model.grammarSymbols += 2 * model.binaryRules;
+        TokenSuffixTree tree(sequence);
+        const vector<TokenNode *> &nodes = tree.getNodes();
+        // Menor y mayor posición de cada subárbol (de abajo hacia arriba sobre el preorden).
+        vector<int> firstLeaf(nodes.size(), INT32_MAX), lastLeaf(nodes.size(), -1);
+        for (size_t k = nodes.size(); k-- > 0;) {
+            const TokenNode *node = nodes[k];
+            if (node->isLeaf() && node->suffixIndex < n)
+                firstLeaf[node->id] = lastLeaf[node->id] = node->suffixIndex;
+            if (node->parent != nullptr) {
+                const int p = node->parent->id;
+                firstLeaf[p] = min(firstLeaf[p], firstLeaf[node->id]);
+                lastLeaf[p] = max(lastLeaf[p], lastLeaf[node->id]);
+            }
+        }
+        vector<Candidate> candidates;
+        for (TokenNode *node: nodes) {
+            long long length = node->stringDepth;
+            if (node->isLeaf() || length < max(minLength, 2))
+                continue;
+            // leafCount cuenta ocurrencias solapadas: en un texto periódico una repetición de longitud
+            // ~n/2 tiene ~n/período hojas pero solo 2 ocurrencias disjuntas. Las ocurrencias disjuntas
+            // caben en el tramo [primera, última + L), así que son a lo sumo tramo / L.
+            const long long span = static_cast<long long>(lastLeaf[node->id]) - firstLeaf[node->id] + length;
+            const long long disjoint = min(static_cast<long long>(node->leafCount), span / length);
+            double gain = model.gain(disjoint, length);
+            if (gain > 0)
+                candidates.push_back({node, gain});
+        }
+        sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            return a.gain != b.gain ? a.gain > b.gain : a.node->stringDepth > b.node->stringDepth;
+        });
+
+        map<int, int> taken; // Intervalos reemplazados en esta ronda: inicio -> fin (exclusivo)
+        vector<Token> replacement(n, TERMINAL_TOKEN); // replacement[p] = no terminal que empieza en p
+        long long budget = 4LL * n; // Cota de hojas visitadas por ronda (evita O(n²) con textos repetitivos)
+        vector<int> positions;
+        for (const Candidate &candidate: candidates) {
+            // Una ronda sin reglas sigue con los candidatos siguientes (más cortos) aunque se agote la
+            // cota, para que los rechazados no impidan reemplazar las repeticiones cortas.
+            if (budget <= 0 && !taken.empty())
+                break;
+            const int length = candidate.node->stringDepth;
+            positions.clear();
+            tree.collectLeaves(candidate.node, positions);
+            budget -= static_cast<long long>(positions.size());
+            sort(positions.begin(), positions.end());
+            vector<int> chosen;
+            for (int p: positions) {
+                if (!chosen.empty() && p < chosen.back() + length)
+                    continue; // Se solapa con la ocurrencia anterior
+                auto next = taken.lower_bound(p);
+                if (next != taken.end() && next->first < p + length)
+                    continue;
+                if (next != taken.begin() && prev(next)->second > p)
+                    continue;
+                chosen.push_back(p);
+            }
+            if (chosen.size() < 2 || model.gain(static_cast<long long>(chosen.size()), length) <= 0)
+                continue;
+            model.apply(static_cast<long long>(chosen.size()), length);
+            Token symbol = NONTERMINAL_BASE + static_cast<Token>(flatRules.size());
+            flatRules.emplace_back(sequence.begin() + chosen[0], sequence.begin() + chosen[0] + length);
+            for (int p: chosen) {
+                taken[p] = p + length;
+                replacement[p] = symbol;
+            }
+        }
+        if (taken.empty())
+            return false;
+
+        vector<Token> next;
+        next.reserve(n);
+        for (int i = 0; i < n;) {
+            if (replacement[i] != TERMINAL_TOKEN) {
+                next.push_back(replacement[i]);
+                i = taken[i];
+            } else {
+                next.push_back(sequence[i++]);
+            }
+        }
+        sequence.swap(next);
+        return true;
+    }
+
+    // Convierte una secuencia en un árbol binario balanceado de reglas (reusando pares ya creados).
+    static Token binarize(vector<Token> symbols, StraightLineProgram &program,
+                          map<pair<Token, Token>, Token> &pairs) {
+        while (symbols.size() > 1) {
+            vector<Token> level;
+            for (size_t k = 0; k + 1 < symbols.size(); k += 2) {
+                pair<Token, Token> key = {symbols[k], symbols[k + 1]};
+                auto it = pairs.find(key);
+                if (it == pairs.end())
+                    it = pairs.emplace(key, program.addRule(key.first, key.second)).first;
+                level.push_back(it->second);
+            }
+            if (symbols.size() % 2 == 1)
+                level.push_back(symbols.back());
+            symbols.swap(level);
+        }
+        return symbols[0];
+    }
+
+public:
+    // [EXTRA] Comprime 'text' con rondas de reemplazo de repeticiones (de longitud >= minLength) hasta
+    // que ninguna sea rentable o se alcance maxRounds; 'rounds' recibe el número de rondas ejecutadas.
+    static StraightLineProgram compress(const string &text, int minLength = 2, int maxRounds = 64,
+                                        int *rounds = nullptr) {
+        vector<Token> sequence(text.begin(), text.end());
+        for (Token &symbol: sequence)
+            symbol &= 0xFF; // char con signo -> byte
+        vector<vector<Token> > flatRules; // Reglas de longitud arbitraria (no terminales de las rondas)
+        int executed = 0;
+        while (executed < maxRounds && sequence.size() > 1) {
+            executed++;
+            if (!replaceRound(sequence, flatRules, minLength))
+                break;
+        }
+        if (rounds != nullptr)
+            *rounds = executed;
+
+        // Las reglas de una ronda solo usan no terminales de rondas anteriores, por lo que se pueden
+        // binarizar en orden de creación.
+        StraightLineProgram program;
+        map<pair<Token, Token>, Token> pairs;
+        vector<Token> binaryOf(flatRules.size());
+        auto translate = [&binaryOf](Token symbol) {
+            return symbol < NONTERMINAL_BASE ? symbol : binaryOf[symbol - NONTERMINAL_BASE];
+        };
+        for (size_t r = 0; r < flatRules.size(); r++) {
+            vector<Token> body;
+            for (Token symbol: flatRules[r])
+                body.push_back(translate(symbol));
+            binaryOf[r] = binarize(body, program, pairs);
+        }
+        for (Token symbol: sequence)
+            program.append(translate(symbol));
+        // El modelo de ganancia es una estimación: si la gramática resulta más grande que el texto
+        // sin reglas, se guarda el texto tal cual.
+        StraightLineProgram plain;
+        for (char c: text)
+            plain.append(static_cast<Token>(static_cast<unsigned char>(c)));
+        return program.serializedSize() <= plain.serializedSize() ? program : plain;
+    }
+
+    // [EXTRA] Compresión, descompresión y 'accessQueries' accesos aleatorios sobre 'text', con la razón
+    // de compresión (bytes originales / bytes serializados) y las velocidades. roundTrip indica si el texto
+    // descomprimido coincide con 'text'.
+    static CompressionReport benchmark(const string &text, int accessQueries = 100000, int minLength = 2) {
+        CompressionReport report{};
+        report.originalBytes = static_cast<long long>(text.size());
+        auto begin = chrono::steady_clock::now();
+        StraightLineProgram program = compress(text, minLength, 64, &report.rounds);
+        report.compressSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        report.compressedBytes = program.serializedSize();
+        report.ratio = report.compressedBytes > 0 ? static_cast<double>(report.originalBytes) / report.compressedBytes : 0;
+        report.rules = program.ruleCount();
+
+        begin = chrono::steady_clock::now();
+        string decoded = program.decode();
+        report.decodeSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        report.roundTrip = decoded == text;
+        const double megabytes = static_cast<double>(report.originalBytes) / 1e6;
+        report.compressMBps = report.compressSeconds > 0 ? megabytes / report.compressSeconds : 0;
+        report.decodeMBps = report.decodeSeconds > 0 ? megabytes / report.decodeSeconds : 0;
+
+        if (!text.empty() && accessQueries > 0) {
+            mt19937_64 random(42);
+            uniform_int_distribution<long long> position(0, program.length() - 1);
+            volatile char sink = 0;
+            begin = chrono::steady_clock::now();
+            for (int q = 0; q < accessQueries; q++)
+                sink = sink ^ program.access(position(random));
+            report.accessNanos = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() /
+                                 accessQueries;
+        }
+        return report;
+    }
+
+    // [EXTRA] benchmark() sobre 'unit' repetido 'copies' veces: el caso periódico, donde las repeticiones
+    // más largas se solapan consigo mismas y solo unas pocas de sus ocurrencias son disjuntas.
+    static CompressionReport benchmarkPeriodic(const string &unit, int copies, int accessQueries = 100000,
+                                               int minLength = 2) {
+        string text;
+        text.reserve(unit.size() * static_cast<size_t>(max(copies, 0)));
+        for (int k = 0; k < copies; k++)
+            text += unit;
+        return benchmark(text, accessQueries, minLength);
+    }
+};
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_GRAMMARCOMPRESSOR_H
@@ -0,0 +1,189 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_HUGEPAGEARENA_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_HUGEPAGEARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+using namespace std;
+
+// ======================= Arena respaldada por huge pages =======================
+// Bump allocator para los nodos del suffix tree. Los bloques empiezan en FIRST_BLOCK_SIZE y crecen al
+// doble, así que un árbol chico solo reserva unos KB. Desde HUGE_PAGE_SIZE los bloques son múltiplos de
+// 2 MB alineados a 2 MB para que el kernel pueda respaldarlos con huge pages y cada entrada de la TLB
+// cubra 2 MB de nodos en lugar de 4 KB:
+//  1. mmap con MAP_HUGETLB (huge pages explícitas de hugetlbfs, si el sistema tiene un pool reservado);
+//  2. si no, mmap anónimo alineado a 2 MB con madvise(MADV_HUGEPAGE) (transparent huge pages);
+//  3. si mmap falla (por ejemplo, por vm.max_map_count o límites de overcommit) o el sistema no tiene
+//     mmap, un bloque del heap con operator new.
+// Sin huge pages (o si el sistema no las da) la arena se comporta como un allocator normal. Las
+// direcciones de mmap son direcciones de usuario sin etiquetas; el heap, en cambio, puede devolver
+// punteros con tag en los bits altos (TBI/MTE de AArch64), así que cada bloque del heap se verifica
+// contra 'addressMask' (los bits que el usuario puede ocupar; ChildRef usa los 16 bits altos). Solo si
+// tampoco el heap da direcciones dentro de la máscara (o no hay memoria) se lanza bad_alloc.
+// La memoria no se libera por objeto; release() (y el destructor) devuelven todos los bloques juntos,
+// por lo que solo debe usarse con tipos trivialmente destructibles.
+class HugePageArena {
+private:
+    static constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+    static constexpr size_t FIRST_BLOCK_SIZE = size_t(64) << 10;
+    static constexpr size_t PAGE_SIZE = size_t(4) << 10;
+    static constexpr size_t MAX_BLOCK_SIZE = size_t(256) << 20;
+
+    // Cómo se obtuvo un bloque, para liberarlo con la función correspondiente.
+    enum class Source {
+        HUGETLB, TRANSPARENT, MMAP, HEAP
+    };
+
+    struct Block {
+        void *base; // Dirección a liberar
+        size_t size; // Tamaño a liberar
+        Source source;
+    };
+
+    vector<Block> blocks;
+    char *cursor; // Siguiente byte libre del bloque actual
+    size_t remaining; // Bytes libres en el bloque actual
+    size_t nextBlockSize; // Los bloques crecen al doble hasta MAX_BLOCK_SIZE
+    size_t reserved; // Bytes reservados en todos los bloques
+    bool hugePages; // false = mmap sin huge pages (para comparar con y sin huge pages)
+    uintptr_t addressMask; // Bits que pueden tener las direcciones entregadas
+
+    // Reserva un bloque de al menos 'bytes' y lo deja como bloque actual. Los bloques chicos son
+    // múltiplos de 4 KB sin huge pages; desde HUGE_PAGE_SIZE, múltiplos de 2 MB alineados.
+    void grow(size_t bytes) {
+        size_t size = max(nextBlockSize, bytes);
+        const bool huge = size >= HUGE_PAGE_SIZE;
+        const size_t unit = huge ? HUGE_PAGE_SIZE : PAGE_SIZE;
+        size = (size + unit - 1) / unit * unit;
+        nextBlockSize = min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+        Block block{nullptr, size, Source::HEAP};
+        char *start = nullptr;
+#if defined(__unix__) || defined(__APPLE__)
+        if (huge && hugePages) {
+#ifdef MAP_HUGETLB
+            void *explicitPages = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (explicitPages != MAP_FAILED) {
+                block = {explicitPages, size, Source::HUGETLB};
+                start = static_cast<char *>(explicitPages);
+            }
+#endif
+        }
+        if (start == nullptr) {
+            // Los bloques de huge pages piden 2 MB de más para poder alinear el inicio a un límite de
+            // huge page.
+            size_t mapped = huge ? size + HUGE_PAGE_SIZE : size;
+            void *pages = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (pages != MAP_FAILED) {
+                uintptr_t address = reinterpret_cast<uintptr_t>(pages);
+                uintptr_t aligned = huge ? (address + HUGE_PAGE_SIZE - 1) & ~(uintptr_t(HUGE_PAGE_SIZE) - 1) : address;
+                start = reinterpret_cast<char *>(aligned);
+                block = {pages, mapped, Source::MMAP};
+#ifdef MADV_HUGEPAGE
+                if (huge && hugePages && madvise(start, size, MADV_HUGEPAGE) == 0)
+                    block.source = Source::TRANSPARENT;
+#endif
+#ifdef MADV_NOHUGEPAGE
+                if (huge && !hugePages)
+                    madvise(start, size, MADV_NOHUGEPAGE);
+#endif
+            }
+        }
+#endif
+        if (start == nullptr) {
+            start = static_cast<char *>(::operator new(size));
+            block = {start, size, Source::HEAP};
+            const uintptr_t first = reinterpret_cast<uintptr_t>(start), last = first + size - 1;
+            if (((first | last) & ~addressMask) != 0) {
+                ::operator delete(start);
+                throw bad_alloc();
+            }
+        }
+        blocks.push_back(block);
+        cursor = start;
+        remaining = size;
+        reserved += size;
+    }
+
+public:
+    explicit HugePageArena(bool hugePages = true, uintptr_t addressMask = UINTPTR_MAX)
+        : cursor(nullptr), remaining(0), nextBlockSize(FIRST_BLOCK_SIZE), reserved(0), hugePages(hugePages),
+          addressMask(addressMask) {
+    }
+
+    HugePageArena(const HugePageArena &) = delete;
+    HugePageArena &operator=(const HugePageArena &) = delete;
+
+    ~HugePageArena() {
+        release();
+    }
+
+    // Memoria para 'bytes' bytes alineada a 'alignment' (potencia de 2, a lo sumo 2 MB).
+    void *allocate(size_t bytes, size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        if (cursor == nullptr || padding + bytes > remaining) {
+            grow(bytes + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        }
+        char *result = cursor + padding;
+        cursor += padding + bytes;
+        remaining -= padding + bytes;
+        return result;
+    }
+
+    // Construye un T en la arena (T debe ser trivialmente destructible: nunca se llama a su destructor).
+    template<typename T, typename... Args>
+    T *create(Args &&... args) {
+        return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Arreglo de 'count' elementos T inicializados por valor.
+    template<typename T>
+    T *createArray(size_t count) {
+        T *array = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t k = 0; k < count; k++)
+            new(array + k) T();
+        return array;
+    }
+
+    // Devuelve todos los bloques (invalida todo lo asignado).
+    void release() {
+        for (const Block &block: blocks) {
+#if defined(__unix__) || defined(__APPLE__)
+            if (block.source != Source::HEAP) {
+                munmap(block.base, block.size);
+                continue;
+            }
+#endif
+            ::operator delete(block.base);
+        }
+        blocks.clear();
+        cursor = nullptr;
+        remaining = 0;
+        reserved = 0;
+        nextBlockSize = FIRST_BLOCK_SIZE;
+    }
+
+    size_t bytesReserved() const {
+        return reserved;
+    }
+
+    // Número de bloques respaldados por huge pages (explícitas o con MADV_HUGEPAGE aceptado).
+    int hugePageBlocks() const {
+        int count = 0;
+        for (const Block &block: blocks)
+            count += block.source == Source::HUGETLB || block.source == Source::TRANSPARENT;
+        return count;
+    }
+
+    int blockCount() const {
+        return static_cast<int>(blocks.size());
+    }
+};
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_HUGEPAGEARENA_H
@@ -0,0 +1,195 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_STATICSUFFIXTREE_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_STATICSUFFIXTREE_H
+
+#include <string_view>
+#include "SuffixTree.h"
+
+// ======================= Suffix tree estático (constexpr) =======================
+// Suffix tree de un literal fijo construido en tiempo de compilación, para diccionarios pequeños
+// embebidos en el binario:
+//
+//     constexpr StaticSuffixTree keywords("BANANA$");
+//     static_assert(keywords.search("NAN"));
+//
+// Los nodos viven en arreglos planos dentro del objeto (sin heap ni punteros), por lo que un objeto
+// constexpr queda en la sección de datos de solo lectura y no tiene costo de inicialización.
+// La construcción inserta los sufijos uno por uno (O(n²)), lo cual es adecuado para los tamaños
+// que el compilador puede evaluar; para textos grandes se usa SuffixTree (Ukkonen).
+// Un carácter fuera de 'A'..'Z' y '$' en el literal es un error de compilación.
+template<size_t N> // N = sizeof del literal (incluye el '\0'); el texto debe terminar en '$'
+class StaticSuffixTree {
+private:
+    static constexpr int LENGTH = static_cast<int>(N) - 1; // Longitud del texto (con '$', sin '\0')
+    static constexpr int MAX_NODES = 2 * static_cast<int>(N); // Cota de nodos: n hojas + n - 1 internos + raíz
+
+    char text[N]{};
+    int start[MAX_NODES]{}; // Arista del nodo: text[start .. end] (ambos inclusive)
+    int end[MAX_NODES]{};
+    int stringDepth[MAX_NODES]{};
+    int suffixIndex[MAX_NODES]{}; // Para hojas, posición del sufijo; -1 en nodos internos
+    int leafCount[MAX_NODES]{};
+    int parent[MAX_NODES]{};
+    int children[MAX_NODES][ALPHABET_SIZE]{}; // Índice del hijo por carácter (0 = no hay hijo; la raíz es 0)
+    int nodeCount = 0;
+
+    constexpr int newNode(int from, int to, int depth, int up) {
+        int id = nodeCount++;
+        start[id] = from;
+        end[id] = to;
+        stringDepth[id] = depth;
+        parent[id] = up;
+        suffixIndex[id] = -1;
+        for (int c = 0; c < ALPHABET_SIZE; c++)
+            children[id][c] = 0;
+        return id;
+    }
+
+    // Inserta el sufijo text[i..]: desciende comparando carácter a carácter y, en la primera
+    // discrepancia, cuelga una hoja (dividiendo la arista si la discrepancia está en su interior).
+    constexpr void insertSuffix(int i) {
+        int node = 0;
+        int pos = i;
+        while (true) {
+            int idx = getIndex(text[pos]);
+            int child = children[node][idx];
+            if (child == 0) {
+                int leaf = newNode(pos, LENGTH - 1, stringDepth[node] + (LENGTH - pos), node);
+                suffixIndex[leaf] = i;
+                children[node][idx] = leaf;
+                return;
+            }
+            int k = 0;
+            int edge = end[child] - start[child] + 1;
+            while (k < edge && text[start[child] + k] == text[pos + k])
+                k++;
+            if (k == edge) {
+                node = child;
+                pos += edge;
+                continue;
+            }
+            // Discrepancia dentro de la arista: el nodo interno toma los primeros k caracteres.
+            int split = newNode(start[child], start[child] + k - 1, stringDepth[node] + k, node);
+            children[node][idx] = split;
+            start[child] += k;
+            parent[child] = split;
+            children[split][getIndex(text[start[child]])] = child;
+            int leaf = newNode(pos + k, LENGTH - 1, stringDepth[split] + (LENGTH - pos - k), split);
+            suffixIndex[leaf] = i;
+            children[split][getIndex(text[pos + k])] = leaf;
+            return;
+        }
+    }
+
+    // Nodo más alto cuyo path label tiene a 'pattern' como prefijo; -1 si no aparece.
+    constexpr int locate(std::string_view pattern) const {
+        int node = 0;
+        size_t pos = 0;
+        while (pos < pattern.size()) {
+            int idx = getIndex(pattern[pos]);
+            if (idx < 0 || idx >= ALPHABET_SIZE || children[node][idx] == 0)
+                return -1;
+            int child = children[node][idx];
+            for (int k = start[child]; k <= end[child] && pos < pattern.size(); k++, pos++) {
+                if (text[k] != pattern[pos])
+                    return -1;
+            }
+            node = child;
+        }
+        return node;
+    }
+
+    constexpr bool isLeaf(int node) const {
+        return suffixIndex[node] >= 0;
+    }
+
+public:
+    // ======================= Constructor (constexpr) =======================
+    constexpr explicit StaticSuffixTree(const char (&s)[N]) {
+        for (size_t k = 0; k < N; k++)
+            text[k] = s[k];
+        newNode(-1, -1, 0, -1);
+        for (int i = 0; i < LENGTH; i++)
+            insertSuffix(i);
+        // leafCount en orden inverso de preorden (los hijos antes que el padre), con pila en un arreglo.
+        int order[MAX_NODES]{};
+        int stack[MAX_NODES]{};
+        int top = 0, visited = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            int node = stack[--top];
+            order[visited++] = node;
+            for (int c = 0; c < ALPHABET_SIZE; c++) {
+                if (children[node][c] != 0)
+                    stack[top++] = children[node][c];
+            }
+        }
+        for (int k = visited - 1; k >= 0; k--) {
+            int node = order[k];
+            if (isLeaf(node))
+                leafCount[node] = 1;
+            if (parent[node] >= 0)
+                leafCount[parent[node]] += leafCount[node];
+        }
+    }
+
+    // ======================= Algoritmo 8: Search(P) =======================
+    constexpr bool search(std::string_view pattern) const {
+        return locate(pattern) >= 0;
+    }
+
+    // [EXTRA] Número de ocurrencias de 'pattern'.
+    constexpr int count(std::string_view pattern) const {
+        int node = locate(pattern);
+        return node >= 0 ? leafCount[node] : 0;
+    }
+
+    // ======================= Algoritmo 9: FindAllMatches(P) =======================
+    // Escribe en 'out' las 'capacity' menores posiciones (base 0, ordenadas) y retorna el número total de
+    // ocurrencias, que puede ser mayor que 'capacity'. No usa heap.
+    constexpr int findAllMatches(std::string_view pattern, int *out, int capacity) const {
+        int node = locate(pattern);
+        if (node < 0)
+            return 0;
+        int stack[MAX_NODES]{};
+        int top = 0, written = 0;
+        stack[top++] = node;
+        while (top > 0) {
+            int current = stack[--top];
+            if (isLeaf(current)) {
+                // Inserción ordenada acotada (la cantidad de ocurrencias en un diccionario es pequeña):
+                // con 'out' lleno, la posición nueva desplaza a la mayor si es menor que ella.
+                if (written < capacity || (capacity > 0 && suffixIndex[current] < out[capacity - 1])) {
+                    int k = written < capacity ? written++ : capacity - 1;
+                    while (k > 0 && out[k - 1] > suffixIndex[current]) {
+                        out[k] = out[k - 1];
+                        k--;
+                    }
+                    out[k] = suffixIndex[current];
+                }
+                continue;
+            }
+            for (int c = 0; c < ALPHABET_SIZE; c++) {
+                if (children[current][c] != 0)
+                    stack[top++] = children[current][c];
+            }
+        }
+        return leafCount[node];
+    }
+
+    // Misma interfaz que SuffixTree::findAllMatches (el vector se reserva solo al consultar).
+    vector<int> findAllMatches(std::string_view pattern) const {
+        vector<int> matches(count(pattern));
+        findAllMatches(pattern, matches.data(), static_cast<int>(matches.size()));
+        return matches;
+    }
+
+    constexpr int size() const {
+        return nodeCount;
+    }
+
+    constexpr std::string_view getText() const {
+        return std::string_view(text, LENGTH);
+    }
+};
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_STATICSUFFIXTREE_H
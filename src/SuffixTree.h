@@ -7,6 +7,27 @@
 #include <vector>
 #include <algorithm>
 #include <climits> // Para INT_MAX
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <array>
+#include <cstdint>
+#include <cstdio> // Para remove
+#include <fstream>
+#include <random>
+#include "HugePageArena.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
 using namespace std;
 
 #define ALPHABET_SIZE 27  // 26 letras de 'A' a 'Z' + 1 para '$'
@@ -14,26 +35,124 @@ using namespace std;
 // Función auxiliar para mapear un carácter a un índice
 // (Este mapeo es parte de la definición de la estructura, ya que el paper asume
 //  un alfabeto de tamaño Σ = 26, aquí extendido para incluir '$')
-int getIndex(char c) {
+// [EXTRA] constexpr para poder usarla en StaticSuffixTree (construcción en tiempo de compilación).
+constexpr int getIndex(char c) {
     if (c == '$') return 26;
     return c - 'A';
 }
 
+// ======================= [EXTRA] Normalización del alfabeto =======================
+// Tabla carácter → rank (índice en children) que SuffixTree aplica al vuelo al construir y al buscar,
+// sin copiar el texto ni los patrones: dos caracteres son el mismo para el árbol si tienen el mismo rank.
+// Por defecto reproduce getIndex ('A'-'Z' y '$'); los demás caracteres quedan fuera del alfabeto (NONE),
+// así que un patrón que los contiene no se encuentra. El texto solo debe contener caracteres con rank
+// y '$' (el terminal) no debe compartir su rank con otro carácter.
+class Normalization {
+private:
+    array<uint8_t, 256> ranks;
+
+public:
+    static constexpr uint8_t NONE = 0xFF;
+
+    Normalization() {
+        ranks.fill(NONE);
+        for (char c = 'A'; c <= 'Z'; c++)
+            ranks[static_cast<unsigned char>(c)] = static_cast<uint8_t>(getIndex(c));
+        ranks[static_cast<unsigned char>('$')] = static_cast<uint8_t>(getIndex('$'));
+    }
+
+    // Mayúsculas y minúsculas son el mismo carácter (lo que antes hacía capitalizeString sobre una copia).
+    static Normalization caseFolding() {
+        Normalization normalization;
+        for (char c = 'a'; c <= 'z'; c++)
+            normalization.map(c, static_cast<char>(c - 'a' + 'A'));
+        return normalization;
+    }
+
+    // 'from' pasa a ser el mismo carácter que 'to' (que ya debe tener rank).
+    Normalization &map(char from, char to) {
+        ranks[static_cast<unsigned char>(from)] = ranks[static_cast<unsigned char>(to)];
+        return *this;
+    }
+
+    // Colapsa una clase de caracteres (por ejemplo, todas las vocales) en su representante 'to'.
+    Normalization &collapse(const string &characters, char to) {
+        for (char c: characters)
+            map(c, to);
+        return *this;
+    }
+
+    int rank(char c) const {
+        return ranks[static_cast<unsigned char>(c)];
+    }
+
+    // Hash FNV-1a de la tabla completa (los checkpoints solo se reanudan con la misma normalización).
+    uint64_t hash() const {
+        uint64_t value = 1469598103934665603ULL;
+        for (uint8_t r: ranks) {
+            value ^= r;
+            value *= 1099511628211ULL;
+        }
+        return value;
+    }
+};
+
+struct Node;
+
+// [EXTRA] Referencia a un hijo dentro del arreglo children del padre: el puntero y, en sus 16 bits altos
+// (sin uso en las direcciones de usuario sin tag de x86-64 y AArch64; los nodos siempre vienen de
+// HugePageArena, que lo verifica, ver su comentario), una etiqueta compacta de la arista del hijo, así que el nodo no
+// crece. Etiqueta: bits 10-15 = min(longitud final de la arista, 63) y
+// bits 0-9 = ranks (alphabetRank, 5 bits) de los caracteres 1 y 2 de la arista (el carácter 0 es la
+// posición en children). Permite decidir la Regla 3 de Ukkonen sin cargar el hijo ni el texto.
+// Se convierte implícitamente a Node*, así que se usa como un puntero; se asigna con SuffixTree::setChild.
+struct ChildRef {
+    static constexpr int LABEL_SHIFT = 48;
+    static constexpr uint64_t POINTER_MASK = (uint64_t(1) << LABEL_SHIFT) - 1;
+
+    uint64_t bits = 0;
+
+    ChildRef() = default;
+
+    ChildRef(Node *node, uint32_t label) : bits(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(node)) |
+                                                static_cast<uint64_t>(label) << LABEL_SHIFT) {
+    }
+
+    operator Node *() const {
+        return reinterpret_cast<Node *>(static_cast<uintptr_t>(bits & POINTER_MASK));
+    }
+
+    Node *operator->() const {
+        return *this;
+    }
+
+    uint32_t label() const {
+        return static_cast<uint32_t>(bits >> LABEL_SHIFT);
+    }
+};
+
 // ======================= Estructura de Nodo =======================
 // Esta estructura representa un nodo del suffix tree.
 // [PAPER: Se define que cada nodo contiene la información de la subcadena (a través de start y end)
 //  y un arreglo de punteros a hijos. También se incluye suffixLink para la construcción lineal con Ukkonen.]
 struct Node {
     int start; // Índice de inicio del label (substring) en "text"
+    int id; // [EXTRA] Número del nodo en orden de creación (0 = raíz); indexa los arreglos laterales de SuffixTree
     int *end; // Puntero al índice final del label; para hojas, se comparte la variable global
     int suffixIndex; // Para hojas, almacena la posición del sufijo en "text" (base 0). Para nodos internos, se deja -1.
+    int stringDepth; // [EXTRA] Longitud del path label desde la raíz (se asigna en setSuffixIndexByDFS)
     Node *suffixLink; // [PAPER: Algoritmo 3] Suffix link para optimizar la construcción
-    Node *children[ALPHABET_SIZE]; // Arreglo de punteros a hijos, uno por cada posible carácter
+    // Arreglo de hijos, uno por cada posible carácter. [EXTRA] Cada entrada guarda, junto al puntero,
+    // una etiqueta compacta de la arista del hijo (ver ChildRef).
+    ChildRef children[ALPHABET_SIZE];
+    Node *parent; // [EXTRA] Padre en el árbol (nullptr en la raíz), mantenido por SuffixTree::setChild
+    int leafCount; // [EXTRA] Número de hojas (ocurrencias) en el subárbol, asignado en setSuffixIndexByDFS
 
-    // Constructor: Inicializa los atributos
-    Node(int start, int *end) : start(start), end(end), suffixIndex(0), suffixLink(nullptr) {
-        for (int i = 0; i < ALPHABET_SIZE; i++)
-            children[i] = nullptr;
+    // Constructor: Inicializa los atributos. Los datos de los índices opcionales viven en arreglos de
+    // SuffixTree indexados por 'id', para que el nodo no crezca con cada índice.
+    Node(int start, int *end, int id = 0) : start(start), id(id), end(end), suffixIndex(0), stringDepth(0),
+                                            suffixLink(nullptr), parent(nullptr),
+                                            leafCount(0) {
     }
 
     // Calcula la longitud del borde (edge) de este nodo
@@ -43,6 +162,368 @@ struct Node {
     }
 };
 
+// ======================= [EXTRA] Locus de un substring =======================
+// Posición de un substring en el árbol: 'node' es el nodo más alto cuyo path label tiene al substring
+// como prefijo (el substring termina en 'node' o dentro de su arista) y 'depth' es la longitud del substring.
+// Un locus con node == nullptr representa un substring que no aparece en el texto.
+struct Locus {
+    Node *node;
+    int depth;
+
+    bool found() const {
+        return node != nullptr;
+    }
+};
+
+// ======================= [EXTRA] Coincidencia maximal entre consulta y referencia =======================
+// query[queryPos .. queryPos + length - 1] == text[refPos .. refPos + length - 1], sin poder extenderse
+// a la izquierda ni a la derecha.
+struct MaximalMatch {
+    int refPos;
+    int queryPos;
+    int length;
+
+    bool operator<(const MaximalMatch &other) const {
+        if (queryPos != other.queryPos)
+            return queryPos < other.queryPos;
+        return refPos < other.refPos;
+    }
+
+    bool operator==(const MaximalMatch &other) const {
+        return refPos == other.refPos && queryPos == other.queryPos && length == other.length;
+    }
+};
+
+// ======================= [EXTRA] Resultado de matching por diccionario =======================
+// Ocurrencias de un patrón como span [begin, begin + count) del orden lexicográfico de hojas
+// (SuffixTree::getLeafOrder()); count = 0 si el patrón no aparece.
+struct DictionaryMatch {
+    Locus locus;
+    int begin;
+    int count;
+};
+
+// ======================= [EXTRA] Substrings comunes a dos árboles =======================
+// Segmento de la co-recorrida de dos suffix trees: los prefijos de longitud minLength..maxLength de
+// text[offset ..] (del árbol que recorre) aparecen en ambos textos, countSelf y countOther veces. Como
+// ninguno de los dos árboles ramifica dentro del segmento, todos sus substrings tienen los mismos
+// conteos. 'branching' indica que maxLength termina en un nodo interno de alguno de los árboles (el
+// substring ramifica); si no, el segmento termina porque las aristas dejan de coincidir.
+struct CommonSegment {
+    int offset; // Ocurrencia en el texto del árbol que recorre
+    int otherOffset; // Ocurrencia en el texto del otro árbol
+    int minLength;
+    int maxLength;
+    int countSelf;
+    int countOther;
+    bool branching;
+};
+
+// Resultado de SuffixTree::benchmarkDictionary(): tiempos para el mismo conjunto de patrones.
+struct DictionaryBenchmark {
+    int patterns;
+    long long occurrences; // Total de ocurrencias de todos los patrones
+    double dictionarySeconds; // matchDictionary (solo spans)
+    double dictionaryWithOccurrencesSeconds; // matchDictionary + materializar las posiciones de cada span
+    double findAllMatchesSeconds; // findAllMatches por patrón
+    double patternsPerSecond; // Con matchDictionary
+    double speedup; // findAllMatchesSeconds / dictionaryWithOccurrencesSeconds
+};
+
+// Resultado de SuffixTree::benchmarkMaximalMatches(): MEM y MUM de una consulta sintética contra una
+// referencia sintética, con un hilo y con 'threads' hilos.
+struct MaximalMatchBenchmark {
+    int referenceLength;
+    int queryLength;
+    unsigned threads;
+    double buildSeconds; // Construcción del árbol de la referencia
+    long long mems;
+    long long mums;
+    double memSequentialSeconds;
+    double memSeconds; // Con 'threads' hilos
+    double mumSequentialSeconds;
+    double mumSeconds;
+    double memSpeedup; // memSequentialSeconds / memSeconds
+    double mumSpeedup;
+    double queryMBps; // MB/s de consulta en findMaximalExactMatches con 'threads' hilos
+};
+
+// Resultado de SuffixTree::benchmarkWindowQueries(): LRS/SUS restringidos a ventanas aleatorias, con el
+// índice del texto completo y reconstruyendo el árbol de cada ventana.
+struct WindowQueryBenchmark {
+    int windowLength;
+    int queries;
+    double indexSeconds; // buildLCPIndex, una sola vez para todas las consultas
+    double windowLrsNanos; // Promedio por consulta con el índice
+    double windowSusNanos;
+    double rebuildLrsNanos; // Promedio por consulta construyendo el árbol de la ventana
+    double rebuildSusNanos;
+    double lrsSpeedup; // rebuildLrsNanos / windowLrsNanos
+    double susSpeedup;
+    int mismatches; // Consultas donde las longitudes de ambos métodos difieren (debe ser 0)
+};
+
+// Resultado de SuffixTree::benchmarkHugePages(): el mismo texto construido y consultado con y sin
+// huge pages. Los fallos de TLB son -1 si tlbCountersAvailable es false.
+struct HugePageBenchmark {
+    int textLength;
+    int patterns;
+    int searches; // patterns × pasadas
+    int hugePageBlocks; // Bloques de la arena respaldados por huge pages en el árbol con huge pages
+    double hugeBuildSeconds;
+    double plainBuildSeconds;
+    double hugeSearchNanos; // Promedio por search()
+    double plainSearchNanos;
+    bool tlbCountersAvailable; // false si perf_event_open no da el contador de fallos de la dTLB
+    long long hugeBuildTlbMisses;
+    long long plainBuildTlbMisses;
+    long long hugeSearchTlbMisses;
+    long long plainSearchTlbMisses;
+    double buildSpeedup; // plainBuildSeconds / hugeBuildSeconds
+    double searchSpeedup; // plainSearchNanos / hugeSearchNanos
+};
+
+// ======================= [EXTRA] Contador de fallos de TLB de datos =======================
+// Fallos de la dTLB en lecturas del hilo actual (solo modo usuario), con perf_event_open. No está
+// disponible fuera de Linux, en máquinas virtuales sin PMU virtualizada o si perf_event_paranoid no lo
+// permite; en ese caso available() es false y stop() retorna -1.
+class TlbMissCounter {
+private:
+    int fd;
+
+public:
+    TlbMissCounter() : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    TlbMissCounter(const TlbMissCounter &) = delete;
+    TlbMissCounter &operator=(const TlbMissCounter &) = delete;
+
+    ~TlbMissCounter() {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    bool available() const {
+        return fd >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long value = 0;
+            if (read(fd, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value)))
+                return value;
+        }
+#endif
+        return -1;
+    }
+};
+
+// ======================= [EXTRA] Frase de la factorización LZ77 =======================
+// text[position .. position + length - 1] == text[source .. source + length - 1] con source < position;
+// una frase literal (carácter que no apareció antes) tiene length = 1 y source = -1.
+struct LZ77Phrase {
+    int position;
+    int length;
+    int source;
+};
+
+// ======================= [EXTRA] Control de consultas largas =======================
+// Estado final de una consulta que acepta un QueryControl.
+enum class QueryStatus {
+    COMPLETED, // El recorrido terminó por completo; el resultado es exacto
+    TIMED_OUT, // Se alcanzó el deadline; el resultado es parcial
+    CANCELLED // Se activó el token de cancelación; el resultado es parcial
+};
+
+// Deadline y token de cancelación cooperativa para los recorridos largos (LRS, SUS, FindAllMatches).
+// Los recorridos llaman a shouldStop() en cada nodo visitado, pero el reloj y el flag solo se
+// consultan cada 'checkInterval' nodos para que el costo de la verificación sea despreciable.
+struct QueryControl {
+    chrono::steady_clock::time_point deadline; // Instante límite (time_point::max() = sin deadline)
+    const atomic<bool> *cancelFlag; // Flag externo de cancelación (puede ser nullptr)
+    int checkInterval; // Cada cuántos nodos se consulta el reloj y el flag
+    int counter; // Nodos visitados desde la última verificación
+    QueryStatus status; // Se actualiza cuando el recorrido es interrumpido
+
+    explicit QueryControl(chrono::steady_clock::time_point deadline,
+                          const atomic<bool> *cancelFlag = nullptr, int checkInterval = 1024)
+        : deadline(deadline), cancelFlag(cancelFlag), checkInterval(checkInterval), counter(0),
+          status(QueryStatus::COMPLETED) {
+    }
+
+    // Control solo con token de cancelación (sin deadline).
+    explicit QueryControl(const atomic<bool> *cancelFlag, int checkInterval = 1024)
+        : QueryControl(chrono::steady_clock::time_point::max(), cancelFlag, checkInterval) {
+    }
+
+    // Control con un presupuesto de tiempo relativo al instante actual.
+    static QueryControl withTimeout(chrono::milliseconds timeout, const atomic<bool> *cancelFlag = nullptr) {
+        return QueryControl(chrono::steady_clock::now() + timeout, cancelFlag);
+    }
+
+    // Retorna true si el recorrido debe detenerse. Una vez interrumpido, sigue retornando true.
+    bool shouldStop() {
+        if (status != QueryStatus::COMPLETED)
+            return true;
+        if (++counter < checkInterval)
+            return false;
+        counter = 0;
+        if (cancelFlag != nullptr && cancelFlag->load(memory_order_relaxed)) {
+            status = QueryStatus::CANCELLED;
+            return true;
+        }
+        if (deadline != chrono::steady_clock::time_point::max() && chrono::steady_clock::now() >= deadline) {
+            status = QueryStatus::TIMED_OUT;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Resultado (posiblemente parcial) de una consulta con QueryControl.
+template<typename T>
+struct QueryResult {
+    T value; // Mejor resultado encontrado hasta el momento de terminar o interrumpir
+    QueryStatus status; // COMPLETED si 'value' es exacto
+};
+
+// ======================= [EXTRA] Perfil de forma del árbol =======================
+// Histograma de valores enteros no negativos. Con escala lineal, counts[v] cuenta el valor v;
+// con escala logarítmica, counts[0] cuenta el valor 0 y counts[k] el rango [2^(k-1), 2^k).
+// La escala logarítmica mantiene acotado el tamaño para profundidades y longitudes de hasta n.
+struct Histogram {
+    bool logScale;
+    vector<long long> counts;
+    long long total; // Número de valores agregados
+    long long sum; // Suma de los valores (para la media)
+    long long maxValue;
+
+    explicit Histogram(bool logScale) : logScale(logScale), total(0), sum(0), maxValue(0) {
+    }
+
+    void add(long long value) {
+        size_t bucket = 0;
+        if (!logScale) {
+            bucket = static_cast<size_t>(value);
+        } else {
+            while (value >> bucket)
+                bucket++;
+        }
+        if (bucket >= counts.size())
+            counts.resize(bucket + 1, 0);
+        counts[bucket]++;
+        total++;
+        sum += value;
+        maxValue = max(maxValue, value);
+    }
+
+    void merge(const Histogram &other) {
+        if (other.counts.size() > counts.size())
+            counts.resize(other.counts.size(), 0);
+        for (size_t i = 0; i < other.counts.size(); i++)
+            counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        maxValue = max(maxValue, other.maxValue);
+    }
+
+    void writeJson(ostream &out) const {
+        out << "{\"scale\":\"" << (logScale ? "log2" : "linear") << "\",\"total\":" << total
+                << ",\"max\":" << maxValue << ",\"mean\":" << (total ? static_cast<double>(sum) / total : 0.0)
+                << ",\"counts\":[";
+        for (size_t i = 0; i < counts.size(); i++)
+            out << (i ? "," : "") << counts[i];
+        out << "]}";
+    }
+};
+
+// Distribuciones de forma de un suffix tree, producidas por SuffixTree::profile().
+struct TreeProfile {
+    long long internalNodes; // Incluye la raíz
+    long long leaves;
+    long long missingSuffixLinks; // Nodos internos (no raíz) sin suffixLink asignado
+    Histogram internalNodeDepth; // Profundidad en nodos de los nodos internos (raíz = 0)
+    Histogram internalStringDepth; // Profundidad en caracteres de los nodos internos
+    Histogram fanOut; // Número de hijos por nodo interno
+    Histogram edgeLength; // Longitud de la arista de cada nodo distinto de la raíz
+    Histogram leafNodeDepth; // Profundidad en nodos de las hojas
+    Histogram suffixLinkChain; // Saltos por suffix link desde cada nodo interno hasta la raíz (vacío si es disperso)
+
+    TreeProfile() : internalNodes(0), leaves(0), missingSuffixLinks(0), internalNodeDepth(true),
+                    internalStringDepth(true), fanOut(false), edgeLength(true), leafNodeDepth(true),
+                    suffixLinkChain(true) {
+    }
+
+    void merge(const TreeProfile &other) {
+        internalNodes += other.internalNodes;
+        leaves += other.leaves;
+        missingSuffixLinks += other.missingSuffixLinks;
+        internalNodeDepth.merge(other.internalNodeDepth);
+        internalStringDepth.merge(other.internalStringDepth);
+        fanOut.merge(other.fanOut);
+        edgeLength.merge(other.edgeLength);
+        leafNodeDepth.merge(other.leafNodeDepth);
+        suffixLinkChain.merge(other.suffixLinkChain);
+    }
+
+    // Escribe el perfil como un objeto JSON directamente sobre 'out' (sin construir un string intermedio).
+    void writeJson(ostream &out) const {
+        out << "{\"internalNodes\":" << internalNodes << ",\"leaves\":" << leaves
+                << ",\"missingSuffixLinks\":" << missingSuffixLinks << ",\"internalNodeDepth\":";
+        internalNodeDepth.writeJson(out);
+        out << ",\"internalStringDepth\":";
+        internalStringDepth.writeJson(out);
+        out << ",\"fanOut\":";
+        fanOut.writeJson(out);
+        out << ",\"edgeLength\":";
+        edgeLength.writeJson(out);
+        out << ",\"leafNodeDepth\":";
+        leafNodeDepth.writeJson(out);
+        out << ",\"suffixLinkChain\":";
+        suffixLinkChain.writeJson(out);
+        out << "}\n";
+    }
+};
+
+// ======================= [EXTRA] Checkpoints de construcción =======================
+// Opciones del constructor con checkpoints: cada 'interval' fases de Ukkonen se guarda en 'path' el
+// árbol parcial junto con el active point. Con 'resume', si 'path' contiene un checkpoint válido del
+// mismo texto, la construcción continúa desde esa fase en lugar de empezar de cero.
+struct CheckpointOptions {
+    string path;
+    int interval; // Fases entre checkpoints (0 = no se guardan checkpoints)
+    bool resume; // Reanudar desde 'path' si existe un checkpoint compatible
+    bool removeOnSuccess; // Borrar el checkpoint al terminar la construcción
+
+    explicit CheckpointOptions(string path, int interval = 1 << 20, bool resume = true, bool removeOnSuccess = true)
+        : path(std::move(path)), interval(interval), resume(resume), removeOnSuccess(removeOnSuccess) {
+    }
+};
+
 // ======================= Clase SuffixTree =======================
 // Esta clase implementa el suffix tree usando Ukkonen's algorithm (algoritmos 1 a 6)
 // y provee operaciones como búsqueda, encontrar todas las coincidencias (Algoritmo 8-9),
@@ -51,6 +532,7 @@ class SuffixTree {
 private:
     // ===== Campos principales (usados en la construcción) =====
     string text; // Texto de entrada, debe incluir el símbolo terminal '$'
+    Normalization normalization; // [EXTRA] Rank de cada carácter del texto y de los patrones
     Node *root; // [PAPER: "Create an empty root node"] Nodo raíz del árbol
     Node *activeNode; // Nodo activo (active point) durante la construcción
     int activeLength; // Longitud activa (cuántos caracteres se han recorrido en la arista activa)
@@ -58,6 +540,66 @@ private:
     int remainingSuffixCount; // Número de sufijos pendientes de inserción (según Ukkonen)
     int leafEnd; // Variable global "end" que se comparte entre todas las hojas
     Node *lastCreatedNode; // Último nodo interno creado, utilizado para asignar suffix links (Algoritmo 3)
+    bool sparse; // [EXTRA] true si solo se indexó un subconjunto de sufijos (constructor disperso)
+
+    // ===== [EXTRA] Memoria de los nodos =====
+    HugePageArena arena{hugePagesEnabled, ChildRef::POINTER_MASK}; // Nodos e índices 'end' internos
+
+    int nodeCount = 0; // Nodos creados; los ids van de 0 a nodeCount - 1
+
+    Node *newNode(int start, int *end) {
+        Node *node = arena.create<Node>(start, end, nodeCount++);
+        if (checkpointing)
+            checkpointNodes.push_back(node);
+        return node;
+    }
+
+    int *newEnd(int value) {
+        return arena.create<int>(value);
+    }
+
+    // ===== [EXTRA] Alfabeto normalizado =====
+    // Todas las comparaciones de caracteres del árbol pasan por aquí, así que la normalización se
+    // aplica al vuelo sobre el texto y los patrones originales.
+    int alphabetRank(char c) const {
+        return normalization.rank(c);
+    }
+
+    bool sameChar(char a, char b) const {
+        return normalization.rank(a) == normalization.rank(b);
+    }
+
+    // ===== [EXTRA] Etiquetas de arista en el padre (ChildRef::label) =====
+    static constexpr int CACHED_CHARS = 3; // Caracteres de la arista conocidos desde el padre (incluye el primero)
+    static constexpr int LABEL_CHAR_BITS = 5;
+    static constexpr uint32_t LABEL_CHAR_MASK = (1u << LABEL_CHAR_BITS) - 1;
+    static constexpr int LABEL_LENGTH_SHIFT = LABEL_CHAR_BITS * (CACHED_CHARS - 1);
+
+    // Asigna 'child' como hijo 'idx' de 'parent' y guarda su etiqueta compacta. La longitud es la final:
+    // una hoja llega hasta el '$' (el texto completo se conoce de antemano), y durante Ukkonen su
+    // longitud actual nunca es menor que activeLength + 1, así que la etiqueta sigue siendo válida.
+    // Debe llamarse después de fijar child->start (por ejemplo, tras dividir una arista). Los nodos vienen
+    // de la arena, que solo entrega direcciones dentro de ChildRef::POINTER_MASK.
+    void setChild(Node *parent, int idx, Node *child) {
+        assert((reinterpret_cast<uintptr_t>(child) >> ChildRef::LABEL_SHIFT) == 0);
+        const int length = child->end == &leafEnd ? static_cast<int>(text.size()) - child->start
+                                                  : *child->end - child->start + 1;
+        uint32_t label = static_cast<uint32_t>(min(length, 63)) << LABEL_LENGTH_SHIFT;
+        for (int k = 1; k < CACHED_CHARS && k < length; k++)
+            label |= (static_cast<uint32_t>(alphabetRank(text[child->start + k])) & LABEL_CHAR_MASK)
+                    << (LABEL_CHAR_BITS * (k - 1));
+        parent->children[idx] = ChildRef(child, label);
+        child->parent = parent;
+    }
+
+    // Longitud (acotada) de la arista y carácter k (1 <= k < CACHED_CHARS) guardados en una etiqueta.
+    static int labelLength(uint32_t label) {
+        return static_cast<int>(label >> LABEL_LENGTH_SHIFT);
+    }
+
+    static uint32_t labelChar(uint32_t label, int k) {
+        return (label >> (LABEL_CHAR_BITS * (k - 1))) & LABEL_CHAR_MASK;
+    }
 
     // ===== Variables para Algoritmo 10: Longest Repeated Substring (LRS) =====
     int maxDepth; // Profundidad máxima (longitud total) alcanzada en un nodo interno repetido
@@ -66,25 +608,698 @@ private:
     // ===== Variables para Algoritmo 11: Shortest Unique Substring (SUS) =====
     int minLength; // Longitud mínima encontrada para un substring único
 
+    // ===== [EXTRA] Control de la consulta en curso (nullptr = sin límite) =====
+    QueryControl *activeControl;
+
+    // Retorna true si la consulta en curso debe abandonar el recorrido.
+    bool queryInterrupted() {
+        return activeControl != nullptr && activeControl->shouldStop();
+    }
+
+    // ===== [EXTRA] Weiner links =====
+    bool weinerLinksBuilt; // true una vez ejecutado buildWeinerLinks()
+    vector<Node *> weinerLinks; // ALPHABET_SIZE links por nodo, en el bloque del id del nodo
+
+    Node *&weinerLink(const Node *node, int c) {
+        return weinerLinks[static_cast<size_t>(node->id) * ALPHABET_SIZE + c];
+    }
+
+    // Inicio en "text" de una ocurrencia del path label de 'node': la arista de cada nodo se creó
+    // inmediatamente después de una ocurrencia del path label de su padre, por lo que el label
+    // completo termina en *node->end.
+    int labelStart(const Node *node) const {
+        return *node->end - node->stringDepth + 1;
+    }
+
+    // ===== [EXTRA] Índice para locus(i, j) =====
+    bool locusIndexBuilt; // true una vez ejecutado buildLocusIndex()
+    vector<Node *> leafOf; // Hoja de cada sufijo, indexada por suffixIndex
+    vector<Node *> pathNodes; // Nodos ordenados por heavy path (cada path contiguo, de arriba hacia abajo)
+    vector<Node *> pathHead; // pathHead[id] = nodo superior del heavy path del nodo
+    vector<int> pathIndex; // pathIndex[id] = posición del nodo en pathNodes
+
+    // ===== [EXTRA] Rank/select sobre substrings distintos =====
+    bool substringCountsBuilt; // true una vez ejecutado buildSubstringCounts()
+    vector<long long> subtreeSubstrings; // subtreeSubstrings[id] = substrings distintos bajo el nodo
+
+    // ===== [EXTRA] Orden de hojas (matching por diccionario) =====
+    bool leafOrderBuilt; // true una vez ejecutado buildLeafOrder()
+    vector<int> leafOrder; // suffixIndex de las hojas en orden lexicográfico (arreglo de sufijos)
+    vector<int> leafBegin; // leafBegin[id] = rango de la primera hoja del subárbol del nodo en leafOrder
+
+    // ===== [EXTRA] Longest previous factor =====
+    vector<int> minLeaf; // minLeaf[id] = menor suffixIndex del subárbol (vacío hasta buildMinLeaf)
+
+    // Se calcula de las hojas hacia la raíz recorriendo un BFS al revés (cada hijo antes que su padre).
+    void buildMinLeaf() {
+        if (!minLeaf.empty())
+            return;
+        minLeaf.assign(nodeCount, INT_MAX);
+        vector<Node *> order = {root};
+        for (size_t k = 0; k < order.size(); k++) {
+            for (const auto &child: order[k]->children) {
+                if (child != nullptr)
+                    order.push_back(child);
+            }
+        }
+        for (size_t k = order.size(); k-- > 0;) {
+            Node *node = order[k];
+            if (isLeafNode(node) && node != root)
+                minLeaf[node->id] = node->suffixIndex;
+            if (node->parent != nullptr)
+                minLeaf[node->parent->id] = min(minLeaf[node->parent->id], minLeaf[node->id]);
+        }
+    }
+
+    // ===== [EXTRA] LCP entre sufijos arbitrarios (consultas sobre ventanas) =====
+    vector<int> suffixRank; // suffixRank[i] = posición del sufijo i en leafOrder
+    vector<vector<int> > lcpTable; // Sparse table: lcpTable[k][r] = min de LCP adyacentes en [r, r + 2^k)
+
+    // LCP de los sufijos en los rangos r1 < r2 de leafOrder: mínimo de los LCP adyacentes en [r1, r2).
+    int lcpOfRanks(int r1, int r2) const {
+        int k = 31 - __builtin_clz(static_cast<unsigned>(r2 - r1));
+        return min(lcpTable[k][r1], lcpTable[k][r2 - (1 << k)]);
+    }
+
+    // ===== [EXTRA] Range successor sobre el orden de hojas (consultas de periodicidad) =====
+    // Merge-sort tree: positionLevels[h] contiene leafOrder con cada bloque alineado de 2^h ordenado.
+    vector<vector<int> > positionLevels;
+
+    void buildRangeSuccessor() {
+        if (!positionLevels.empty())
+            return;
+        buildLeafOrder();
+        positionLevels.push_back(leafOrder);
+        const size_t size = leafOrder.size();
+        for (size_t block = 2; block / 2 < size; block *= 2) {
+            vector<int> level(size);
+            const vector<int> &previous = positionLevels.back();
+            for (size_t from = 0; from < size; from += block) {
+                size_t middle = min(from + block / 2, size), to = min(from + block, size);
+                merge(previous.begin() + from, previous.begin() + middle, previous.begin() + middle,
+                      previous.begin() + to, level.begin() + from);
+            }
+            positionLevels.push_back(level);
+        }
+    }
+
+    // Menor posición ≥ x (o, con 'successor' = false, mayor posición ≤ x) entre leafOrder[lo, hi);
+    // -1 si no hay. [lo, hi) se descompone en O(log n) bloques alineados: O(log² n).
+    int rangeNeighbor(int lo, int hi, int x, bool successor) const {
+        int best = -1;
+        while (lo < hi) {
+            int h = 0;
+            while (h + 1 < static_cast<int>(positionLevels.size()) && lo % (2 << h) == 0 && lo + (2 << h) <= hi)
+                h++;
+            const vector<int> &level = positionLevels[h];
+            auto begin = level.begin() + lo, end = level.begin() + lo + (1 << h);
+            if (successor) {
+                auto it = lower_bound(begin, end, x);
+                if (it != end && (best == -1 || *it < best))
+                    best = *it;
+            } else {
+                auto it = upper_bound(begin, end, x);
+                if (it != begin && (best == -1 || *prev(it) > best))
+                    best = *prev(it);
+            }
+            lo += 1 << h;
+        }
+        return best;
+    }
+
+    // Posiciones de la ventana [a, b] ordenadas por rango, y en adjacent[k] el LCP entre las posiciones
+    // k y k + 1 de ese orden.
+    void sortWindow(int a, int b, vector<int> &sorted, vector<int> &adjacent) {
+        sorted.clear();
+        for (int r = a; r <= b; r++)
+            sorted.push_back(suffixRank[r]);
+        sort(sorted.begin(), sorted.end());
+        adjacent.assign(sorted.size() > 0 ? sorted.size() - 1 : 0, 0);
+        for (size_t k = 0; k + 1 < sorted.size(); k++)
+            adjacent[k] = lcpOfRanks(sorted[k], sorted[k + 1]);
+        for (int &rank: sorted)
+            rank = leafOrder[rank];
+    }
+
+    // Substrings distintos que aporta la arista de 'node': su longitud, sin el '$' final de las hojas.
+    static int effectiveLength(Node *node) {
+        return node->edgeLength() - (isLeafNode(node) ? 1 : 0);
+    }
+
+    // ===== [EXTRA] Matching statistics =====
+    // Recorre query[from .. to - 1] y llama a visit(q, locus) con el locus del prefijo más largo de
+    // query[q..] que aparece en el texto (matching statistics). Entre posiciones consecutivas se
+    // descarta el primer carácter siguiendo el suffix link del nodo explícito sobre el locus y se
+    // re-desciende con skip/count, por lo que el costo total es O(to - from + longitud del último match).
+    // En un árbol disperso no hay suffix links y cada posición se resuelve desde la raíz.
+    template<typename Visitor>
+    void matchingStatisticsRange(const string &query, int from, int to, Visitor visit) {
+        const int m = static_cast<int>(query.size());
+        Locus current = rootLocus();
+        for (int q = from; q < to; q++) {
+            while (q + current.depth < m && query[q + current.depth] != '$') {
+                Locus next = extendRight(current, query[q + current.depth]);
+                if (!next.found())
+                    break;
+                current = next;
+            }
+            visit(q, current);
+            if (current.depth == 0)
+                continue;
+            if (sparse) {
+                current = rootLocus();
+                continue;
+            }
+            // Nodo explícito en o sobre el locus, y su suffix link (la raíz si no tiene).
+            Node *above = current.depth == current.node->stringDepth ? current.node : current.node->parent;
+            Node *link = (above == root || above->suffixLink == nullptr) ? root : above->suffixLink;
+            current = rescan(link, query, q + 1 + link->stringDepth, current.depth - 1 - link->stringDepth);
+        }
+    }
+
+    // Skip/count: desciende desde 'node' consumiendo 'count' caracteres de query[pos..], que se sabe
+    // que aparecen en el árbol; solo se mira el primer carácter de cada arista.
+    Locus rescan(Node *node, const string &query, int pos, int count) {
+        while (count > 0) {
+            Node *child = node->children[alphabetRank(query[pos])];
+            int length = child->edgeLength();
+            if (count < length)
+                return {child, node->stringDepth + count};
+            node = child;
+            pos += length;
+            count -= length;
+        }
+        return {node, node->stringDepth};
+    }
+
+    // Agrega a 'out' los matches (r, q, length) de 'leaves' que no se pueden extender a la izquierda.
+    void reportLeftMaximal(const string &query, int q, int length, const vector<int> &leaves,
+                           vector<MaximalMatch> &out) {
+        for (int r: leaves) {
+            if (q == 0 || r == 0 || !sameChar(query[q - 1], text[r - 1]))
+                out.push_back({r, q, length});
+        }
+    }
+
+    // Valida una ventana [a, b] para las consultas restringidas (no incluye el '$') y prepara el índice.
+    bool windowQuery(int a, int b) {
+        if (sparse || a < 0 || b < a || b >= static_cast<int>(text.size()) - 1)
+            return false;
+        buildLCPIndex();
+        return true;
+    }
+
+    // Locus del substring del locus sin su primer carácter: suffix link del nodo explícito en o sobre
+    // el locus y skip/count sobre los caracteres del propio texto. En un árbol disperso no hay suffix
+    // links y el substring acortado puede no estar indexado, así que (como en matchingStatisticsRange)
+    // se vuelve a la raíz.
+    Locus suffixLocus(const Locus &locus) {
+        if (locus.depth <= 1 || sparse)
+            return rootLocus();
+        Node *above = locus.depth == locus.node->stringDepth ? locus.node : locus.node->parent;
+        Node *link = (above == root || above->suffixLink == nullptr) ? root : above->suffixLink;
+        return rescan(link, text, labelStart(locus.node) + 1 + link->stringDepth, locus.depth - 1 - link->stringDepth);
+    }
+
+    // Ejecuta work(from, to, t) sobre 'parts' rangos contiguos de [0, n), cada uno en su propio hilo.
+    template<typename Work>
+    static void parallelChunks(int n, unsigned parts, Work work) {
+        if (parts <= 1 || n < 2) {
+            work(0, n, 0u);
+            return;
+        }
+        vector<thread> workers;
+        for (unsigned t = 0; t < parts; t++) {
+            int from = static_cast<int>(static_cast<long long>(n) * t / parts);
+            int to = static_cast<int>(static_cast<long long>(n) * (t + 1) / parts);
+            workers.emplace_back([=]() { work(from, to, t); });
+        }
+        for (thread &worker: workers)
+            worker.join();
+    }
+
+    static unsigned resolveThreads(unsigned threads) {
+        return threads == 0 ? max(1u, thread::hardware_concurrency()) : threads;
+    }
+
+    // ===== [EXTRA] Entropía empírica =====
+    vector<double> entropyByOrder; // entropyByOrder[k] = H_k (vacío hasta llamar a buildEntropyProfile)
+
+    // ===== [EXTRA] Auxiliares para profile() =====
+    // Nodo pendiente en el recorrido del perfil, con su profundidad en nodos y en caracteres.
+    struct ProfileItem {
+        Node *node;
+        int nodeDepth;
+        int stringDepth;
+    };
+
+    static bool isLeafNode(const Node *node) {
+        for (const auto &child: node->children) {
+            if (child != nullptr)
+                return false;
+        }
+        return true;
+    }
+
+    // Saltos por suffix link desde cada nodo interno (indexado por id) hasta la raíz o hasta un nodo
+    // sin suffix link. Se memoiza: cada cadena se recorre hasta el primer nodo ya resuelto, así que
+    // el costo total es O(n). Vacío en un árbol disperso (no tiene suffix links).
+    vector<int> suffixLinkChains;
+
+    void buildSuffixLinkChains() {
+        if (sparse || !suffixLinkChains.empty())
+            return;
+        suffixLinkChains.assign(nodeCount, -1);
+        suffixLinkChains[root->id] = 0;
+        vector<Node *> stack = {root}, chain;
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            for (const auto &child: node->children) {
+                if (child != nullptr && !isLeafNode(child))
+                    stack.push_back(child);
+            }
+            chain.clear();
+            Node *current = node;
+            while (suffixLinkChains[current->id] < 0 && current->suffixLink != nullptr) {
+                chain.push_back(current);
+                current = current->suffixLink;
+            }
+            int hops = max(suffixLinkChains[current->id], 0);
+            suffixLinkChains[current->id] = hops;
+            for (size_t k = chain.size(); k-- > 0;)
+                suffixLinkChains[chain[k]->id] = ++hops;
+        }
+    }
+
+    // Agrega 'item' al perfil y apila sus hijos en 'pending'. Requiere buildSuffixLinkChains().
+    void profileNode(const ProfileItem &item, TreeProfile &p, vector<ProfileItem> *pending) {
+        Node *node = item.node;
+        if (node != root)
+            p.edgeLength.add(node->edgeLength());
+        int fanOut = 0;
+        for (const auto &child: node->children) {
+            if (child != nullptr) {
+                fanOut++;
+                pending->push_back({child, item.nodeDepth + 1, item.stringDepth + child->edgeLength()});
+            }
+        }
+        if (fanOut == 0 && node != root) {
+            p.leaves++;
+            p.leafNodeDepth.add(item.nodeDepth);
+            return;
+        }
+        p.internalNodes++;
+        p.internalNodeDepth.add(item.nodeDepth);
+        p.internalStringDepth.add(item.stringDepth);
+        p.fanOut.add(fanOut);
+        if (node != root && node->suffixLink == nullptr && item.stringDepth > 1)
+            p.missingSuffixLinks++;
+        if (!sparse)
+            p.suffixLinkChain.add(suffixLinkChains[node->id]);
+    }
+
+    // ===== [EXTRA] Checkpoints de construcción =====
+    int resumedPhase; // Fase desde la que se reanudó la construcción (0 = desde cero)
+
+    // Formato (enteros en el orden de bytes del host): cabecera con versión, longitud y hash FNV-1a del
+    // texto, hash de la tabla de normalización, fase, active point, remainingSuffixCount, leafEnd, número de nodos y número de registros;
+    // luego un registro por nodo, identificado por su id (estable: un nodo conserva su id al reanudar).
+    // Los checkpoints son incrementales: cada uno agrega al final del archivo solo los nodos creados
+    // desde el anterior y los nodos anteriores que cambiaron (una división de arista mueve el inicio
+    // y el padre del nodo dividido), y al final reescribe la cabecera. Así el costo total de los
+    // checkpoints es O(n) en lugar de O(n) por checkpoint. Al cargar, el último registro de cada id
+    // es el que vale; los registros más allá de los que declara la cabecera (de un checkpoint
+    // interrumpido) se ignoran y se sobrescriben. 'checksum' es el FNV-1a de los registros declarados
+    // seguido de la cabecera (con checksum = 0): un byte alterado descarta el checkpoint.
+    struct CheckpointHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t textLength;
+        uint64_t textHash;
+        uint64_t normalizationHash;
+        uint64_t checksum;
+        int32_t phase;
+        int32_t activeNode;
+        int32_t activeEdge;
+        int32_t activeLength;
+        int32_t remainingSuffixCount;
+        int32_t leafEnd;
+        int32_t nodeCount;
+        int32_t recordCount;
+    };
+
+    struct CheckpointNode {
+        int32_t id;
+        int32_t start;
+        int32_t end; // -1 si la hoja comparte leafEnd
+        int32_t parent; // -1 en la raíz; el hijo se ubica en parent->children por el rank de text[start]
+        int32_t suffixLink;
+    };
+
+    static constexpr uint32_t CHECKPOINT_MAGIC = 0x4B435453; // "STCK"
+    static constexpr uint32_t CHECKPOINT_VERSION = 4;
+
+    static constexpr uint64_t FNV_OFFSET = 1469598103934665603ULL;
+
+    // FNV-1a de 'bytes' bytes, continuando desde 'hash'.
+    static uint64_t fnv1a(const void *data, size_t bytes, uint64_t hash = FNV_OFFSET) {
+        const unsigned char *cursor = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            hash ^= cursor[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static uint64_t textHash(const string &s) {
+        return fnv1a(s.data(), s.size());
+    }
+
+    // Checksum de la cabecera: el hash de los registros seguido de la cabecera con checksum = 0.
+    static uint64_t headerChecksum(CheckpointHeader header, uint64_t recordsHash) {
+        header.checksum = 0;
+        return fnv1a(&header, sizeof(header), recordsHash);
+    }
+
+    bool checkpointing = false; // true durante una construcción con checkpoints
+    vector<Node *> checkpointNodes; // Nodos por id (solo con checkpointing)
+    vector<Node *> checkpointChanged; // Nodos ya guardados que cambiaron desde el último checkpoint
+    int savedNodes = 0; // Los nodos con id < savedNodes ya están en el archivo
+    int32_t savedRecords = 0; // Registros válidos en el archivo (0 = hay que crearlo)
+    uint64_t savedRecordsHash = FNV_OFFSET; // FNV-1a de los savedRecords registros del archivo
+    uint64_t checkpointHash = 0; // textHash(text), calculado una sola vez
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Escribe 'bytes' bytes en 'offset' (pwrite puede escribir menos de lo pedido).
+    static bool writeAt(int fd, const void *data, size_t bytes, off_t offset) {
+        const char *cursor = static_cast<const char *>(data);
+        while (bytes > 0) {
+            ssize_t written = pwrite(fd, cursor, bytes, offset);
+            if (written <= 0)
+                return false;
+            cursor += written;
+            bytes -= static_cast<size_t>(written);
+            offset += written;
+        }
+        return true;
+    }
+#endif
+
+    // Agrega al archivo los nodos nuevos y los modificados y luego reescribe la cabecera, de modo que
+    // un corte durante la escritura deja el checkpoint anterior intacto. En POSIX los registros se
+    // llevan a disco (fsync) antes de escribir la cabecera que los declara, y la cabecera también; si el
+    // corte ocurre antes de que el archivo recién creado llegue al directorio, solo se pierde el primer
+    // checkpoint (la construcción se reanuda desde 0).
+    bool saveCheckpoint(const string &path, int phase) {
+        sort(checkpointChanged.begin(), checkpointChanged.end());
+        checkpointChanged.erase(unique(checkpointChanged.begin(), checkpointChanged.end()), checkpointChanged.end());
+        vector<CheckpointNode> records;
+        records.reserve(checkpointChanged.size() + (nodeCount - savedNodes));
+        auto record = [&](const Node *node) {
+            records.push_back({node->id, node->start, node->end == &leafEnd ? -1 : *node->end,
+                               node->parent != nullptr ? node->parent->id : -1,
+                               node->suffixLink != nullptr ? node->suffixLink->id : -1});
+        };
+        for (const Node *node: checkpointChanged)
+            record(node);
+        for (int id = savedNodes; id < nodeCount; id++)
+            record(checkpointNodes[id]);
+        const int32_t recordCount = savedRecords + static_cast<int32_t>(records.size());
+        const uint64_t recordsHash = fnv1a(records.data(), sizeof(CheckpointNode) * records.size(), savedRecordsHash);
+        CheckpointHeader header{CHECKPOINT_MAGIC, CHECKPOINT_VERSION, text.size(), checkpointHash,
+                                normalization.hash(), 0, phase,
+                                activeNode->id, static_cast<unsigned char>(activeEdge), activeLength,
+                                remainingSuffixCount, leafEnd, nodeCount, recordCount};
+        header.checksum = headerChecksum(header, recordsHash);
+#if defined(__unix__) || defined(__APPLE__)
+        {
+            int fd = open(path.c_str(), O_RDWR | O_CREAT | (savedRecords > 0 ? 0 : O_TRUNC), 0644);
+            if (fd < 0)
+                return false;
+            bool written = true;
+            if (savedRecords == 0) { // Cabecera provisional (sin nodos, inválida) hasta terminar de escribir
+                CheckpointHeader provisional = header;
+                provisional.nodeCount = provisional.recordCount = 0;
+                written = writeAt(fd, &provisional, sizeof(provisional), 0);
+            }
+            written = written && writeAt(fd, records.data(), sizeof(CheckpointNode) * records.size(),
+                                         static_cast<off_t>(sizeof(header) + sizeof(CheckpointNode) * savedRecords));
+            written = written && fsync(fd) == 0;
+            written = written && writeAt(fd, &header, sizeof(header), 0) && fsync(fd) == 0;
+            close(fd);
+            if (!written)
+                return false;
+        }
+#else
+        {
+            fstream out(path, savedRecords > 0 ? ios::binary | ios::in | ios::out : ios::binary | ios::out | ios::trunc);
+            if (!out)
+                return false;
+            if (savedRecords == 0) { // Cabecera provisional (sin nodos, inválida) hasta terminar de escribir
+                CheckpointHeader provisional = header;
+                provisional.nodeCount = provisional.recordCount = 0;
+                out.write(reinterpret_cast<const char *>(&provisional), sizeof(provisional));
+            }
+            out.seekp(static_cast<streamoff>(sizeof(header) + sizeof(CheckpointNode) * savedRecords));
+            out.write(reinterpret_cast<const char *>(records.data()), sizeof(CheckpointNode) * records.size());
+            out.flush();
+            if (!out)
+                return false;
+            out.seekp(0);
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.flush();
+            if (!out)
+                return false;
+        }
+#endif
+        savedRecords = recordCount;
+        savedRecordsHash = recordsHash;
+        savedNodes = nodeCount;
+        checkpointChanged.clear();
+        return true;
+    }
+
+    // Reconstruye el árbol parcial y el active point desde 'path'. Retorna la fase guardada, o 0 si el
+    // archivo no existe, está incompleto o corresponde a otro texto (en ese caso no se modifica nada).
+    int loadCheckpoint(const string &path) {
+        ifstream in(path, ios::binary);
+        CheckpointHeader header{};
+        if (!in || !in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            return 0;
+        const int32_t nodes = header.nodeCount, n = static_cast<int32_t>(text.size());
+        if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+            header.textLength != text.size() || header.textHash != checkpointHash ||
+            header.normalizationHash != normalization.hash() || header.phase <= 0 ||
+            header.phase > n || nodes <= 0 || header.recordCount < nodes || header.activeNode < 0 ||
+            header.activeNode >= nodes || header.leafEnd != header.phase - 1 || header.activeLength < 0 ||
+            header.activeLength > header.phase || header.remainingSuffixCount < 0 ||
+            header.remainingSuffixCount > header.phase)
+            return 0;
+        in.seekg(0, ios::end);
+        const streamoff available = in.tellg() - static_cast<streamoff>(sizeof(header));
+        if (available < static_cast<streamoff>(sizeof(CheckpointNode)) * header.recordCount)
+            return 0; // La cabecera declara más registros de los que hay en el archivo
+        in.seekg(sizeof(header));
+        vector<CheckpointNode> records(header.recordCount);
+        if (!in.read(reinterpret_cast<char *>(records.data()), sizeof(CheckpointNode) * records.size()))
+            return 0;
+        const uint64_t recordsHash = fnv1a(records.data(), sizeof(CheckpointNode) * records.size());
+        if (header.checksum != headerChecksum(header, recordsHash))
+            return 0;
+        // Estado final de cada id y validación completa antes de crear nodos.
+        vector<CheckpointNode> state(nodes, CheckpointNode{-1, 0, 0, 0, 0});
+        for (const CheckpointNode &r: records) {
+            if (r.id < 0 || r.id >= nodes)
+                return 0;
+            state[r.id] = r;
+        }
+        vector<int64_t> slots; // parent * ALPHABET_SIZE + slot de cada nodo no raíz
+        for (int32_t id = 0; id < nodes; id++) {
+            const CheckpointNode &r = state[id];
+            if (r.id != id || r.suffixLink < -1 || r.suffixLink >= nodes || (id == 0) != (r.parent == -1))
+                return 0;
+            if (id == 0)
+                continue;
+            if (r.parent < 0 || r.parent >= nodes || r.start < 0 || r.start >= n || r.end < -1 ||
+                (r.end >= 0 && (r.end < r.start || r.end >= n)))
+                return 0;
+            int slot = alphabetRank(text[r.start]);
+            if (slot >= ALPHABET_SIZE)
+                return 0;
+            slots.push_back(static_cast<int64_t>(r.parent) * ALPHABET_SIZE + slot);
+        }
+        sort(slots.begin(), slots.end());
+        if (adjacent_find(slots.begin(), slots.end()) != slots.end())
+            return 0; // Dos hijos en el mismo lugar
+        // Cada nodo debe llegar a la raíz siguiendo a su padre (sin ciclos).
+        vector<char> reaches(nodes, 0);
+        reaches[0] = 1;
+        vector<int32_t> chain;
+        for (int32_t id = 1; id < nodes; id++) {
+            int32_t current = id;
+            chain.clear();
+            while (reaches[current] == 0) {
+                reaches[current] = 2; // En el camino actual
+                chain.push_back(current);
+                current = state[current].parent;
+            }
+            if (reaches[current] == 2)
+                return 0;
+            for (int32_t k: chain)
+                reaches[k] = 1;
+        }
+        vector<Node *> created(nodes);
+        for (int32_t id = 0; id < nodes; id++) {
+            const CheckpointNode &r = state[id];
+            created[id] = newNode(r.start, id == 0 ? newEnd(-1) : r.end == -1 ? &leafEnd : newEnd(r.end));
+        }
+        for (int32_t id = 0; id < nodes; id++) {
+            const CheckpointNode &r = state[id];
+            if (id > 0)
+                setChild(created[r.parent], alphabetRank(text[r.start]), created[id]);
+            if (r.suffixLink >= 0)
+                created[id]->suffixLink = created[r.suffixLink];
+        }
+        root = created[0];
+        activeNode = created[header.activeNode];
+        activeEdge = static_cast<char>(header.activeEdge);
+        activeLength = header.activeLength;
+        remainingSuffixCount = header.remainingSuffixCount;
+        leafEnd = header.leafEnd;
+        lastCreatedNode = nullptr;
+        savedNodes = nodes;
+        savedRecords = header.recordCount;
+        savedRecordsHash = recordsHash;
+        return header.phase;
+    }
+
 public:
+    // [EXTRA] Si es false, los árboles construidos a partir de ese momento usan bloques de mmap sin huge
+    // pages (para comparar ambos modos).
+    static inline bool hugePagesEnabled = true;
+
+    // [EXTRA] Bytes reservados para nodos y cuántos bloques quedaron respaldados por huge pages.
+    size_t nodeBytesReserved() const {
+        return arena.bytesReserved();
+    }
+
+    int hugePageBlocks() const {
+        return arena.hugePageBlocks();
+    }
+
+    // [EXTRA] Construye 'text' (que debe terminar en '$') con y sin huge pages y busca cada patrón
+    // 'passes' veces en cada árbol, midiendo tiempos y, si perf lo permite, fallos de la dTLB. Se mide
+    // un modo a la vez (cada árbol se libera antes de construir el siguiente) y se restaura
+    // hugePagesEnabled al terminar.
+    static HugePageBenchmark benchmarkHugePages(const string &text, const vector<string> &patterns, int passes = 10,
+                                                const Normalization &normalization = Normalization()) {
+        HugePageBenchmark report{};
+        report.textLength = static_cast<int>(text.size());
+        report.patterns = static_cast<int>(patterns.size());
+        passes = max(passes, 1);
+        report.searches = report.patterns * passes;
+        TlbMissCounter counter;
+        report.tlbCountersAvailable = counter.available();
+        const bool previous = hugePagesEnabled;
+        for (bool huge: {false, true}) {
+            hugePagesEnabled = huge;
+            auto begin = chrono::steady_clock::now();
+            counter.start();
+            SuffixTree tree(text, normalization);
+            const long long buildMisses = counter.stop();
+            const double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+            volatile bool sink = false;
+            begin = chrono::steady_clock::now();
+            counter.start();
+            for (int pass = 0; pass < passes; pass++) {
+                for (const string &pattern: patterns)
+                    sink = tree.search(pattern) != sink;
+            }
+            const long long searchMisses = counter.stop();
+            const double searchNanos = report.searches > 0
+                                           ? chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count() /
+                                             report.searches
+                                           : 0;
+            if (huge) {
+                report.hugePageBlocks = tree.hugePageBlocks();
+                report.hugeBuildSeconds = buildSeconds;
+                report.hugeSearchNanos = searchNanos;
+                report.hugeBuildTlbMisses = buildMisses;
+                report.hugeSearchTlbMisses = searchMisses;
+            } else {
+                report.plainBuildSeconds = buildSeconds;
+                report.plainSearchNanos = searchNanos;
+                report.plainBuildTlbMisses = buildMisses;
+                report.plainSearchTlbMisses = searchMisses;
+            }
+        }
+        hugePagesEnabled = previous;
+        report.buildSpeedup = report.hugeBuildSeconds > 0 ? report.plainBuildSeconds / report.hugeBuildSeconds : 0;
+        report.searchSpeedup = report.hugeSearchNanos > 0 ? report.plainSearchNanos / report.hugeSearchNanos : 0;
+        return report;
+    }
+
     // ======================= Constructor =======================
     // [PAPER: Inicialización en Construction(S)]
     // Se espera que 's' ya incluya el símbolo terminal '$'.
-    explicit SuffixTree(string s) : text(std::move(s)), root(nullptr), activeNode(nullptr),
-                                    activeLength(0), activeEdge('\0'), remainingSuffixCount(0),
-                                    leafEnd(-1), lastCreatedNode(nullptr),
-                                    maxDepth(0), bestString(""), minLength(INT_MAX) {
+    // [EXTRA] 'normalization' define qué caracteres son iguales (por ejemplo, Normalization::caseFolding()
+    // para indexar sin distinguir mayúsculas); se aplica al vuelo, sin copiar 's' ni los patrones.
+    explicit SuffixTree(string s, const Normalization &normalization = Normalization())
+        : text(std::move(s)), normalization(normalization), root(nullptr), activeNode(nullptr),
+          activeLength(0), activeEdge('\0'), remainingSuffixCount(0),
+          leafEnd(-1), lastCreatedNode(nullptr), sparse(false),
+          maxDepth(0), bestString(""), minLength(INT_MAX),
+          activeControl(nullptr), weinerLinksBuilt(false),
+          locusIndexBuilt(false), substringCountsBuilt(false), leafOrderBuilt(false),
+          resumedPhase(0) {
         buildSuffixTree(); // Algoritmo 1: Construction(S)
         // [EXTRA] Asignación de suffixIndex a cada hoja mediante una DFS.
         // Esto no aparece explícitamente en el pseudocódigo, pero es esencial en implementaciones prácticas.
         setSuffixIndexByDFS(root, 0);
     }
 
+    // ======================= [EXTRA] Constructor de suffix tree disperso =======================
+    // Indexa solo los sufijos que empiezan en 'positions' (por ejemplo, inicios de palabra o cada
+    // k-ésima posición). Search y FindAllMatches encuentran solo las ocurrencias que empiezan en
+    // posiciones indexadas. La memoria es O(|positions|) nodos en lugar de O(n) (la construcción usa
+    // además un arreglo temporal de n fingerprints de 8 bytes).
+    // No hay suffix links, por lo que los Weiner links (extendLeft) no están disponibles.
+    SuffixTree(string s, vector<int> positions, const Normalization &normalization = Normalization())
+        : text(std::move(s)), normalization(normalization), root(nullptr), activeNode(nullptr),
+          activeLength(0), activeEdge('\0'), remainingSuffixCount(0),
+          leafEnd(-1), lastCreatedNode(nullptr), sparse(true),
+          maxDepth(0), bestString(""), minLength(INT_MAX),
+          activeControl(nullptr), weinerLinksBuilt(false),
+          locusIndexBuilt(false), substringCountsBuilt(false),
+          leafOrderBuilt(false), resumedPhase(0) {
+        buildSparseSuffixTree(std::move(positions));
+        setSuffixIndexByDFS(root, 0);
+    }
+
+    // ======================= [EXTRA] Constructor con checkpoints =======================
+    // Igual que SuffixTree(s, normalization), pero guarda checkpoints periódicos durante Ukkonen y, si
+    // options.resume y options.path contiene un checkpoint de este mismo texto con la misma normalización,
+    // continúa desde la última fase guardada.
+    SuffixTree(string s, const CheckpointOptions &options, const Normalization &normalization = Normalization())
+        : text(std::move(s)), normalization(normalization), root(nullptr), activeNode(nullptr),
+          activeLength(0), activeEdge('\0'), remainingSuffixCount(0),
+          leafEnd(-1), lastCreatedNode(nullptr), sparse(false),
+          maxDepth(0), bestString(""), minLength(INT_MAX),
+          activeControl(nullptr), weinerLinksBuilt(false),
+          locusIndexBuilt(false), substringCountsBuilt(false), leafOrderBuilt(false),
+          resumedPhase(0) {
+        buildSuffixTree(options);
+        setSuffixIndexByDFS(root, 0);
+    }
+
     // ======================= (A) Asignar suffixIndex a las hojas =======================
     // [EXTRA] Función auxiliar: recorre el árbol en DFS y asigna a cada hoja su suffixIndex.
     // Según el paper, la posición del sufijo se puede determinar como n - labelHeight.
     void setSuffixIndexByDFS(Node *node, const int &labelHeight) {
         if (!node) return;
+        node->stringDepth = labelHeight;
         bool isLeaf = true;
         // Recorremos todos los hijos
         for (const auto &i: node->children) {
@@ -93,11 +1308,15 @@ public:
                 Node *child = i;
                 // Llamada recursiva: se suma la longitud del edge del hijo
                 setSuffixIndexByDFS(child, labelHeight + child->edgeLength());
+                node->leafCount += child->leafCount;
             }
         }
-        if (isLeaf) {
+        if (isLeaf && node == root) {
+            node->suffixIndex = -1; // Árbol sin sufijos (texto vacío o disperso sin posiciones): no hay hojas
+        } else if (isLeaf) {
             // Para una cadena de longitud n, el sufijo que empieza en s se identifica con n - labelHeight.
             node->suffixIndex = static_cast<int>(text.size()) - labelHeight;
+            node->leafCount = 1;
         }
     }
 
@@ -105,8 +1324,8 @@ public:
     // Pseudocódigo (ver paper):
     //   For i = 0 to n - 1, llamar a extendSuffixTree(i)
     void buildSuffixTree() {
-        int *rootEnd = new int(-1);
-        root = new Node(-1, rootEnd);
+        int *rootEnd = newEnd(-1);
+        root = newNode(-1, rootEnd);
         activeNode = root;
         activeEdge = '\0';
         activeLength = 0;
@@ -119,11 +1338,185 @@ public:
         }
     }
 
+    // ======================= [EXTRA] Construction(S) con checkpoints =======================
+    // Mismo ciclo que buildSuffixTree(), empezando en la fase del checkpoint si se pudo cargar. Al final
+    // de cada fase (lastCreatedNode ya no se usa) el estado de Ukkonen es exactamente el árbol más el
+    // active point, remainingSuffixCount y leafEnd. Si un checkpoint no se puede escribir, la
+    // construcción continúa sin él.
+    void buildSuffixTree(const CheckpointOptions &options) {
+        const int n = static_cast<int>(text.size());
+        checkpointing = options.interval > 0;
+        checkpointHash = textHash(text);
+        int phase = options.resume ? loadCheckpoint(options.path) : 0;
+        if (phase == 0) {
+            root = newNode(-1, newEnd(-1));
+            activeNode = root;
+            activeEdge = '\0';
+            activeLength = 0;
+            remainingSuffixCount = 0;
+            lastCreatedNode = nullptr;
+            leafEnd = -1;
+        }
+        resumedPhase = phase;
+        for (int i = phase; i < n; i++) {
+            extendSuffixTree(i);
+            if (options.interval > 0 && (i + 1) % options.interval == 0 && i + 1 < n)
+                saveCheckpoint(options.path, i + 1);
+        }
+        checkpointing = false;
+        vector<Node *>().swap(checkpointNodes);
+        vector<Node *>().swap(checkpointChanged);
+        if (options.removeOnSuccess)
+            remove(options.path.c_str());
+    }
+
+    // [EXTRA] Fase desde la que se reanudó la construcción (0 si se construyó desde cero).
+    int getResumedPhase() const {
+        return resumedPhase;
+    }
+
+    // [EXTRA] Ordena los sufijos de 'positions' (sin duplicados) y deja en lcp[k] el LCP de positions[k - 1]
+    // y positions[k]. Comparar sufijos carácter a carácter es cuadrático en textos repetitivos (LCP = Θ(n)),
+    // así que se combinan dos ideas:
+    //  - merge sort con LCP: al mezclar, si el LCP de un candidato con el último sufijo emitido es mayor
+    //    que el del otro, ese candidato es menor, sin mirar el texto; solo con LCP iguales se extiende;
+    //  - longest common extension con fingerprints de Karp-Rabin sobre los ranks (la normalización puede
+    //    igualar caracteres distintos), sumando potencias de dos de mayor a menor: O(log n) por extensión.
+    // Módulo 2^61 - 1 con base aleatoria: la probabilidad de un LCE incorrecto es O(n / 2^61).
+    void sortSparseSuffixes(vector<int> &positions, vector<int> &lcp) {
+        const int n = static_cast<int>(text.size());
+        sort(positions.begin(), positions.end());
+        positions.erase(unique(positions.begin(), positions.end()), positions.end());
+        static constexpr uint64_t MOD = (uint64_t(1) << 61) - 1;
+        auto mulMod = [](uint64_t a, uint64_t b) {
+            unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+            uint64_t r = static_cast<uint64_t>(product & MOD) + static_cast<uint64_t>(product >> 61);
+            return r >= MOD ? r - MOD : r;
+        };
+        const uint64_t base = mt19937_64(chrono::steady_clock::now().time_since_epoch().count())() % (MOD - 256) + 256;
+        vector<uint64_t> hash(n + 1, 0); // hash[i] = fingerprint de text[0..i)
+        for (int i = 0; i < n; i++) {
+            hash[i + 1] = mulMod(hash[i], base) + static_cast<uint64_t>(alphabetRank(text[i])) + 1;
+            if (hash[i + 1] >= MOD)
+                hash[i + 1] -= MOD;
+        }
+        vector<uint64_t> powers = {base}; // powers[k] = base^(2^k)
+        while ((int64_t(1) << powers.size()) <= n)
+            powers.push_back(mulMod(powers.back(), powers.back()));
+        auto fingerprint = [&](int from, int k) { // text[from .. from + 2^k)
+            uint64_t shifted = mulMod(hash[from], powers[k]);
+            return hash[from + (1 << k)] >= shifted ? hash[from + (1 << k)] - shifted
+                                                    : hash[from + (1 << k)] + MOD - shifted;
+        };
+        // LCP de los sufijos a != b sabiendo que comparten al menos 'length' caracteres. El '$' único
+        // garantiza que difieren antes del final del texto.
+        auto lce = [&](int a, int b, int length) {
+            const int limit = n - max(a, b);
+            // Las extensiones cortas (lo usual en textos no repetitivos) se resuelven comparando directamente.
+            for (const int direct = min(limit, length + 32); length < direct; length++) {
+                if (!sameChar(text[a + length], text[b + length]))
+                    return length;
+            }
+            for (int k = static_cast<int>(powers.size()) - 1; k >= 0; k--) {
+                if (length + (1 << k) <= limit && fingerprint(a + length, k) == fingerprint(b + length, k))
+                    length += 1 << k;
+            }
+            return length;
+        };
+
+        const int m = static_cast<int>(positions.size());
+        lcp.assign(m, 0);
+        vector<int> mergedPositions(m), mergedLcp(m);
+        for (int width = 1; width < m; width *= 2) {
+            for (int lo = 0; lo < m; lo += 2 * width) {
+                const int mid = min(lo + width, m), hi = min(lo + 2 * width, m);
+                int i = lo, j = mid, k = lo;
+                int lcpA = 0, lcpB = 0; // LCP de positions[i] y positions[j] con el último sufijo emitido
+                while (i < mid && j < hi) {
+                    bool takeA;
+                    if (lcpA != lcpB) {
+                        takeA = lcpA > lcpB; // El perdedor conserva su LCP con el nuevo último
+                    } else {
+                        int common = lce(positions[i], positions[j], lcpA);
+                        takeA = alphabetRank(text[positions[i] + common]) < alphabetRank(text[positions[j] + common]);
+                        (takeA ? lcpB : lcpA) = common;
+                    }
+                    if (takeA) {
+                        mergedPositions[k] = positions[i];
+                        mergedLcp[k++] = lcpA;
+                        if (++i < mid)
+                            lcpA = lcp[i];
+                    } else {
+                        mergedPositions[k] = positions[j];
+                        mergedLcp[k++] = lcpB;
+                        if (++j < hi)
+                            lcpB = lcp[j];
+                    }
+                }
+                for (bool first = true; i < mid; i++, first = false) {
+                    mergedPositions[k] = positions[i];
+                    mergedLcp[k++] = first ? lcpA : lcp[i];
+                }
+                for (bool first = true; j < hi; j++, first = false) {
+                    mergedPositions[k] = positions[j];
+                    mergedLcp[k++] = first ? lcpB : lcp[j];
+                }
+            }
+            positions.swap(mergedPositions);
+            lcp.swap(mergedLcp);
+        }
+    }
+
+    // ======================= [EXTRA] Construcción dispersa =======================
+    // En lugar de Ukkonen (que inserta los n sufijos), se ordenan los sufijos seleccionados y se
+    // construye el árbol de izquierda a derecha manteniendo una pila con el camino más a la derecha:
+    // cada sufijo nuevo cuelga del nodo de profundidad LCP(anterior, actual), dividiendo una arista
+    // si ese nodo no existe. Costo: O(n) para los fingerprints más O(m log m) pasos de merge sort, de los
+    // cuales solo los que no se deciden por LCP extienden en O(log n) (ver sortSparseSuffixes).
+    void buildSparseSuffixTree(vector<int> positions) {
+        const int n = static_cast<int>(text.size());
+        root = newNode(-1, newEnd(-1));
+        leafEnd = n - 1; // Todas las hojas terminan en el '$' final
+        positions.erase(remove_if(positions.begin(), positions.end(),
+                                  [n](int p) { return p < 0 || p >= n; }), positions.end());
+        if (positions.empty())
+            return; // Ningún sufijo indexado: el árbol es solo la raíz, que no es una hoja
+        vector<int> lcp; // lcp[k] = LCP de los sufijos positions[k - 1] y positions[k]
+        sortSparseSuffixes(positions, lcp);
+
+        vector<Node *> rightmostPath = {root};
+        for (size_t k = 0; k < positions.size(); k++) {
+            const int p = positions[k], common = k > 0 ? lcp[k] : 0;
+            Node *last = nullptr;
+            while (rightmostPath.back()->stringDepth > common) {
+                last = rightmostPath.back();
+                rightmostPath.pop_back();
+            }
+            Node *top = rightmostPath.back();
+            if (top->stringDepth < common) {
+                // El punto de ramificación está dentro de la arista top -> last: se divide.
+                int cut = common - top->stringDepth;
+                Node *splitNode = newNode(last->start, newEnd(last->start + cut - 1));
+                splitNode->stringDepth = common;
+                setChild(top, alphabetRank(text[last->start]), splitNode);
+                last->start += cut;
+                setChild(splitNode, alphabetRank(text[last->start]), last);
+                rightmostPath.push_back(splitNode);
+                top = splitNode;
+            }
+            Node *leaf = newNode(p + common, &leafEnd);
+            leaf->stringDepth = n - p;
+            setChild(top, alphabetRank(text[p + common]), leaf);
+            rightmostPath.push_back(leaf);
+        }
+    }
+
     // ======================= Algoritmo 2: walkDown(nextNode) =======================
     // Pseudocódigo: Si activeLength ≥ edgeLength, actualiza activeEdge, activeLength y activeNode.
-    bool walkDown(Node *nextNode) {
+    // 'i' es la fase actual: los activeLength caracteres bajo activeNode son text[i - activeLength .. i - 1].
+    bool walkDown(Node *nextNode, int i) {
         if (activeLength >= nextNode->edgeLength()) {
-            activeEdge = text[nextNode->start + activeLength]; // Actualiza activeEdge
+            activeEdge = text[i - activeLength + nextNode->edgeLength()]; // Actualiza activeEdge
             activeLength -= nextNode->edgeLength(); // Disminuye activeLength
             activeNode = nextNode; // Mueve activeNode
             return true;
@@ -148,14 +1541,16 @@ public:
     // crea un nodo interno (splitNode) y reorganiza los hijos.
     Node *splitEdge(Node *nextNode, int currentActiveLength) {
         int splitPosition = nextNode->start + currentActiveLength - 1;
-        int *splitEnd = new int(splitPosition);
-        Node *splitNode = new Node(nextNode->start, splitEnd);
+        int *splitEnd = newEnd(splitPosition);
+        Node *splitNode = newNode(nextNode->start, splitEnd);
         // Reasigna el hijo de activeNode para activeEdge al splitNode.
-        activeNode->children[getIndex(activeEdge)] = splitNode;
-        // Asigna nextNode como hijo del splitNode usando el siguiente carácter.
-        splitNode->children[getIndex(text[splitPosition + 1])] = nextNode;
+        setChild(activeNode, alphabetRank(activeEdge), splitNode);
         // Actualiza nextNode.start para que la arista del nodo dividido comience en splitPosition+1.
         nextNode->start = splitPosition + 1;
+        if (checkpointing && nextNode->id < savedNodes)
+            checkpointChanged.push_back(nextNode); // [EXTRA] Cambiaron su inicio y su padre
+        // Asigna nextNode como hijo del splitNode usando el siguiente carácter.
+        setChild(splitNode, alphabetRank(text[splitPosition + 1]), nextNode);
         return splitNode;
     }
 
@@ -176,24 +1571,36 @@ public:
             if (activeLength == 0)
                 activeEdge = text[i];
 
-            int edgeIndex = getIndex(activeEdge);
+            int edgeIndex = alphabetRank(activeEdge);
             // Si no existe un hijo en activeNode para activeEdge:
             if (activeNode->children[edgeIndex] == nullptr) {
                 // [PAPER: Regla 2] Crear una nueva hoja con start = i y end = leafEnd
-                Node *leaf = new Node(i, &leafEnd);
-                activeNode->children[edgeIndex] = leaf;
+                Node *leaf = newNode(i, &leafEnd);
+                setChild(activeNode, edgeIndex, leaf);
                 // Asigna suffixLink al nodo actual si es necesario (Algoritmo 3)
                 createSuffixLink(activeNode, false);
             } else {
                 // Si ya existe un hijo para activeEdge, lo asigna a nextNode
                 Node *nextNode = activeNode->children[edgeIndex];
-                // Si activeLength ≥ nextNode.edgeLength(), usa walkDown (Algoritmo 2)
-                if (activeLength >= nextNode->edgeLength()) {
-                    if (walkDown(nextNode))
-                        continue;
+                // [EXTRA] Si el carácter a comparar está en la etiqueta guardada en activeNode, la
+                // arista es más larga que activeLength (no hace falta walkDown) y la Regla 3 se decide
+                // sin cargar nextNode ni el texto de su arista.
+                const uint32_t label = activeNode->children[edgeIndex].label();
+                bool matches;
+                if (activeLength < CACHED_CHARS && activeLength < labelLength(label)) {
+                    matches = activeLength == 0 ||
+                              labelChar(label, activeLength) ==
+                              (static_cast<uint32_t>(alphabetRank(text[i])) & LABEL_CHAR_MASK);
+                } else {
+                    // Si activeLength ≥ nextNode.edgeLength(), usa walkDown (Algoritmo 2)
+                    if (activeLength >= nextNode->edgeLength()) {
+                        if (walkDown(nextNode, i))
+                            continue;
+                    }
+                    matches = sameChar(text[nextNode->start + activeLength], text[i]);
                 }
                 // Si el siguiente carácter en el edge de nextNode coincide con text[i]:
-                if (text[nextNode->start + activeLength] == text[i]) {
+                if (matches) {
                     // [PAPER: Regla 3] Incrementa activeLength y, si hay un nodo pendiente, actualiza su suffixLink.
                     activeLength = activeLength + 1;
                     if (lastCreatedNode != nullptr)
@@ -204,8 +1611,8 @@ public:
                 // Si hay una discrepancia, se divide la arista (Algoritmo 4)
                 Node *splitNode = splitEdge(nextNode, activeLength);
                 // Crea una nueva hoja para text[i] con start = i y end = leafEnd.
-                Node *leaf = new Node(i, &leafEnd);
-                splitNode->children[getIndex(text[i])] = leaf;
+                Node *leaf = newNode(i, &leafEnd);
+                setChild(splitNode, alphabetRank(text[i]), leaf);
                 // Actualiza lastCreatedNode al nodo interno recién creado.
                 createSuffixLink(splitNode, true);
             }
@@ -224,25 +1631,12 @@ public:
     }
 
     // ======================= Algoritmo 7: Destroy() =======================
-    // [PAPER: Algoritmo 7] Destruye el árbol realizando una travesía postorden.
-    void destroyNode(Node *v) {
-        if (v == nullptr)
-            return;
-        // Recorrer cada hijo y destruirlo.
-        for (int i = 0; i < ALPHABET_SIZE; i++) {
-            if (v->children[i] != nullptr) {
-                destroyNode(v->children[i]);
-            }
-        }
-        // Si el puntero 'end' no es el de la variable global leafEnd, libéralo.
-        if (v->end != &leafEnd)
-            delete v->end;
-        delete v;
-    }
-
-    // Destructor: [EXTRA] Llama a destroyNode para liberar toda la memoria.
+    // [PAPER: Algoritmo 7] Destruye el árbol. [EXTRA] Los nodos y los índices 'end' se asignan en la
+    // arena (Node es trivialmente destructible), así que en lugar de liberar nodo por nodo en postorden se
+    // devuelven todos los bloques de la arena a la vez. Los arreglos por id (Weiner links, heavy paths,
+    // etc.) son vectores y se liberan solos.
     ~SuffixTree() {
-        destroyNode(root);
+        arena.release();
         root = nullptr;
     }
 
@@ -256,9 +1650,10 @@ public:
         // Mientras queden caracteres en P
         while (pos < pattern.size()) {
             char currentChar = pattern[pos];
-            int idx = getIndex(currentChar);
+            int idx = alphabetRank(currentChar);
             // Si no existe hijo en v con label que empieza con P[pos], retorna false.
-            if (v->children[idx] == nullptr)
+            // [EXTRA] También si P[pos] no tiene rank en la normalización del árbol.
+            if (idx >= ALPHABET_SIZE || v->children[idx] == nullptr)
                 return false;
             // Se mueve a ese hijo.
             v = v->children[idx];
@@ -266,7 +1661,7 @@ public:
             int len = (edgeLen < (pattern.size() - pos)) ? edgeLen : (pattern.size() - pos);
             // Compara el substring de la arista con el segmento de P.
             for (int i = 0; i < len; i++) {
-                if (text[v->start + i] != pattern[pos + i])
+                if (!sameChar(text[v->start + i], pattern[pos + i]))
                     return false;
             }
             pos += len;
@@ -284,14 +1679,14 @@ public:
         int pos = 0;
 
         while (pos < (int) pattern.size()) {
-            int idx = getIndex(pattern[pos]);
-            if (v->children[idx] == nullptr)
+            int idx = alphabetRank(pattern[pos]);
+            if (idx >= ALPHABET_SIZE || v->children[idx] == nullptr)
                 return matches; // No se encontró el patrón
             Node *child = v->children[idx];
             int edgeLen = child->edgeLength();
             int len = (edgeLen < (int) pattern.size() - pos) ? edgeLen : ((int) pattern.size() - pos);
             for (int i = 0; i < len; i++) {
-                if (text[child->start + i] != pattern[pos + i])
+                if (!sameChar(text[child->start + i], pattern[pos + i]))
                     return matches; // Discrepancia: patrón no existe
             }
             pos += len;
@@ -305,8 +1700,18 @@ public:
         return matches; // Retorna posiciones en base 0.
     }
 
+    // [EXTRA] FindAllMatches con deadline/cancelación. Si se interrumpe, retorna las posiciones
+    // recolectadas hasta ese momento (ordenadas) junto con el estado TIMED_OUT o CANCELLED.
+    QueryResult<vector<int> > findAllMatches(const string &pattern, QueryControl &control) {
+        activeControl = &control;
+        vector<int> matches = findAllMatches(pattern);
+        activeControl = nullptr;
+        return {matches, control.status};
+    }
+
     // [EXTRA] Método auxiliar: Recolecta los suffixIndex de todas las hojas en el subárbol de 'node'.
     void getLeafIndices(Node *node, vector<int> &matches) {
+        if (queryInterrupted()) return;
         bool isLeaf = true;
         for (int i = 0; i < ALPHABET_SIZE; i++) {
             if (node->children[i] != nullptr) {
@@ -314,7 +1719,7 @@ public:
                 getLeafIndices(node->children[i], matches);
             }
         }
-        if (isLeaf) {
+        if (isLeaf && node != root) {
             matches.push_back(node->suffixIndex);
         }
     }
@@ -329,11 +1734,20 @@ public:
         return bestString;
     }
 
+    // [EXTRA] LRS con deadline/cancelación. Si se interrumpe, retorna el substring repetido
+    // más largo encontrado en la parte del árbol ya recorrida.
+    QueryResult<string> longestRepeatedSubstring(QueryControl &control) {
+        activeControl = &control;
+        string result = longestRepeatedSubstring();
+        activeControl = nullptr;
+        return {result, control.status};
+    }
+
     // DFS auxiliar para LRS.
     // Recorre el árbol, y si un nodo interno tiene al menos 2 hijos y la profundidad es mayor,
     // se actualiza el candidato bestString.
     void lrsDFS(Node *node, int depth, const string &pathSoFar) {
-        if (!node) return;
+        if (!node || queryInterrupted()) return;
         int childCount = 0;
         for (int i = 0; i < ALPHABET_SIZE; i++) {
             if (node->children[i] != nullptr)
@@ -365,12 +1779,21 @@ public:
         return bestString;
     }
 
+    // [EXTRA] SUS con deadline/cancelación. Si se interrumpe, retorna el substring único más corto
+    // encontrado hasta ese momento (puede no ser el mínimo global, o ser vacío).
+    QueryResult<string> shortestUniqueSubstring(QueryControl &control) {
+        activeControl = &control;
+        string result = shortestUniqueSubstring();
+        activeControl = nullptr;
+        return {result, control.status};
+    }
+
     // DFS auxiliar para SUS.
     // Retorna el número de hojas en el subárbol de 'node'.
     // Si un nodo interno tiene exactamente 1 hoja y el path acumulado (sin '$') es menor que el mínimo,
     // se actualiza el candidato.
     int dfsShortestUnique(Node *node, int depth, const string &pathSoFar) {
-        if (!node)
+        if (!node || queryInterrupted())
             return 0;
 
         bool isExplicitLeaf = true;
@@ -388,6 +1811,9 @@ public:
         }
         if (isExplicitLeaf) {
             totalLeaves = 1;
+        } else if (activeControl != nullptr && activeControl->status != QueryStatus::COMPLETED) {
+            // [EXTRA] Recorrido interrumpido: totalLeaves está incompleto, no se evalúan candidatos.
+            return totalLeaves;
         } else {
             // Si este nodo (explícito) tiene exactamente 1 hoja y el path acumulado no contiene '$'
             // y su profundidad es menor que el mínimo encontrado, se actualiza.
@@ -421,6 +1847,1213 @@ public:
         return totalLeaves;
     }
 
+    // ======================= [EXTRA] Weiner links y búsqueda bidireccional =======================
+    // Weiner link W(v, c): nodo más alto cuyo path label tiene a c + label(v) como prefijo (nullptr si
+    // c + label(v) no aparece). Los links explícitos son los suffix links invertidos; los implícitos
+    // (c + label(v) termina dentro de una arista) se heredan del único hijo que tiene W(hijo, c), ya que
+    // si dos hijos lo tuvieran, c + label(v) sería un nodo interno con suffix link hacia v.
+    // Costo: O(n · Σ) en tiempo y memoria; solo se construyen si se llama a este método o a extendLeft.
+    void buildWeinerLinks() {
+        if (weinerLinksBuilt || isSparse())
+            return;
+        vector<Node *> order; // Preorden: los hijos quedan después de su padre
+        vector<Node *> leafOf(text.size(), nullptr);
+        weinerLinks.assign(static_cast<size_t>(nodeCount) * ALPHABET_SIZE, nullptr);
+        vector<Node *> stack = {root};
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+            bool isLeaf = true;
+            for (const auto &child: node->children) {
+                if (child != nullptr) {
+                    isLeaf = false;
+                    stack.push_back(child);
+                }
+            }
+            if (isLeaf && node != root)
+                leafOf[node->suffixIndex] = node;
+        }
+        // Links explícitos: inversos de los suffix links de nodos internos y de las hojas (i -> i - 1).
+        for (Node *node: order) {
+            if (node == root)
+                continue;
+            if (isLeafNode(node)) {
+                if (node->suffixIndex > 0)
+                    weinerLink(node, alphabetRank(text[node->suffixIndex - 1])) = leafOf[node->suffixIndex - 1];
+            } else {
+                Node *target = node->suffixLink != nullptr ? node->suffixLink : root;
+                weinerLink(target, alphabetRank(text[labelStart(node)])) = node;
+            }
+        }
+        // Links implícitos, de abajo hacia arriba.
+        for (size_t k = order.size(); k-- > 0;) {
+            Node *node = order[k];
+            for (int c = 0; c < ALPHABET_SIZE; c++) {
+                if (weinerLink(node, c) != nullptr)
+                    continue;
+                Node *inherited = nullptr;
+                int holders = 0;
+                for (const auto &child: node->children) {
+                    if (child != nullptr && weinerLink(child, c) != nullptr) {
+                        inherited = weinerLink(child, c);
+                        holders++;
+                    }
+                }
+                if (holders == 1)
+                    weinerLink(node, c) = inherited;
+            }
+        }
+        weinerLinksBuilt = true;
+    }
+
+    // [EXTRA] true si el árbol fue construido con el constructor disperso (no todos los sufijos).
+    bool isSparse() const {
+        return sparse;
+    }
+
+    // [EXTRA] Locus del substring vacío (punto de partida de una búsqueda bidireccional).
+    Locus rootLocus() {
+        return {root, 0};
+    }
+
+    // [EXTRA] Locus de 'pattern' (mismo recorrido que Search); node == nullptr si no aparece.
+    Locus locate(const string &pattern) {
+        Locus locus = rootLocus();
+        for (char c: pattern) {
+            locus = extendRight(locus, c);
+            if (!locus.found())
+                break;
+        }
+        return locus;
+    }
+
+    // [EXTRA] Extiende el substring del locus un carácter a la derecha en O(1).
+    Locus extendRight(const Locus &locus, char c) {
+        int idx = alphabetRank(c);
+        if (!locus.found() || idx < 0 || idx >= ALPHABET_SIZE)
+            return {nullptr, 0};
+        Node *node = locus.node;
+        if (locus.depth == node->stringDepth) {
+            Node *child = node->children[idx];
+            if (child == nullptr)
+                return {nullptr, 0};
+            return {child, locus.depth + 1};
+        }
+        // El locus está dentro de la arista de 'node': se compara el siguiente carácter de la arista.
+        int offset = locus.depth - (node->stringDepth - node->edgeLength());
+        if (alphabetRank(text[node->start + offset]) != idx)
+            return {nullptr, 0};
+        return {node, locus.depth + 1};
+    }
+
+    // [EXTRA] Extiende el substring del locus un carácter a la izquierda en O(1) usando Weiner links.
+    // Todas las ocurrencias de un locus dentro de una arista continúan hasta label(node), por lo que
+    // c + substring y c + label(node) tienen las mismas ocurrencias y el mismo nodo de locus.
+    Locus extendLeft(const Locus &locus, char c) {
+        int idx = alphabetRank(c);
+        if (!locus.found() || idx < 0 || idx >= ALPHABET_SIZE)
+            return {nullptr, 0};
+        buildWeinerLinks();
+        if (weinerLinks.empty())
+            return {nullptr, 0}; // Árbol disperso: no hay Weiner links
+        Node *target = weinerLink(locus.node, idx);
+        if (target == nullptr)
+            return {nullptr, 0};
+        return {target, locus.depth + 1};
+    }
+
+    // ======================= [EXTRA] Locus de T[i..j] por posición =======================
+    // Índice para ubicar substrings del texto por posición: un mapa posición -> hoja y una
+    // descomposición en heavy paths (cada nodo continúa por el hijo con más hojas). Los nodos de cada
+    // heavy path quedan contiguos en 'pathNodes' con stringDepth creciente, lo que permite resolver
+    // weighted ancestor queries con búsqueda binaria. Memoria O(n).
+    void buildLocusIndex() {
+        if (locusIndexBuilt)
+            return;
+        leafOf.assign(text.size(), nullptr);
+        pathNodes.clear();
+        pathHead.assign(nodeCount, nullptr);
+        pathIndex.assign(nodeCount, 0);
+        pathHead[root->id] = root;
+        vector<Node *> stack = {root};
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            pathIndex[node->id] = static_cast<int>(pathNodes.size());
+            pathNodes.push_back(node);
+            Node *heavy = nullptr;
+            for (const auto &child: node->children) {
+                if (child != nullptr && (heavy == nullptr || child->leafCount > heavy->leafCount))
+                    heavy = child;
+            }
+            if (heavy == nullptr) {
+                if (node != root)
+                    leafOf[node->suffixIndex] = node;
+                continue;
+            }
+            // Los hijos livianos inician su propio heavy path; el pesado se apila al final para
+            // visitarse inmediatamente después de 'node' y quedar contiguo en pathNodes.
+            for (const auto &child: node->children) {
+                if (child != nullptr && child != heavy) {
+                    pathHead[child->id] = child;
+                    stack.push_back(child);
+                }
+            }
+            pathHead[heavy->id] = pathHead[node->id];
+            stack.push_back(heavy);
+        }
+        locusIndexBuilt = true;
+    }
+
+    // [EXTRA] Locus de T[i..j] (ambos inclusive, base 0) sin recorrer sus caracteres.
+    // Es el ancestro más alto de la hoja del sufijo i con stringDepth ≥ j - i + 1 (weighted ancestor).
+    // Se sube por heavy paths completos (O(log n) aristas livianas) y se hace una búsqueda binaria
+    // en el último: O(log n) por consulta.
+    Locus locus(int i, int j) {
+        if (i < 0 || j < i || j >= static_cast<int>(text.size()))
+            return {nullptr, 0};
+        buildLocusIndex();
+        const int length = j - i + 1;
+        Node *current = leafOf[i];
+        if (current == nullptr)
+            return {nullptr, 0}; // Árbol disperso: el sufijo i no está indexado
+        while (true) {
+            Node *head = pathHead[current->id];
+            if (head != root && head->parent->stringDepth >= length) {
+                current = head->parent;
+                continue;
+            }
+            // El ancestro buscado está en el heavy path entre 'head' y 'current'.
+            int lo = pathIndex[head->id], hi = pathIndex[current->id];
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (pathNodes[mid]->stringDepth >= length)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            return {pathNodes[lo], length};
+        }
+    }
+
+    // [EXTRA] Número de ocurrencias del substring del locus (O(1)).
+    int locusCount(const Locus &locus) {
+        return locus.found() ? locus.node->leafCount : 0;
+    }
+
+    // [EXTRA] Número de ocurrencias de 'pattern' en el texto, en O(|pattern|) sin recolectar hojas.
+    int count(const string &pattern) {
+        return locusCount(locate(pattern));
+    }
+
+    // ======================= [EXTRA] Rank/select sobre substrings distintos =======================
+    // Cada punto del árbol (excepto la raíz) es un substring distinto, y el orden de los hijos por
+    // alphabetRank es el orden lexicográfico. Se ignoran los substrings que contienen '$' (solo el último
+    // carácter de cada arista de hoja). subtreeSubstrings(v) = Σ hijos w (effectiveLength(w) + subtreeSubstrings(w)).
+    void buildSubstringCounts() {
+        if (substringCountsBuilt)
+            return;
+        subtreeSubstrings.assign(nodeCount, 0);
+        vector<Node *> order = {root};
+        for (size_t k = 0; k < order.size(); k++) {
+            for (const auto &child: order[k]->children) {
+                if (child != nullptr)
+                    order.push_back(child);
+            }
+        }
+        for (size_t k = order.size(); k-- > 0;) {
+            Node *node = order[k];
+            for (const auto &child: node->children) {
+                if (child != nullptr)
+                    subtreeSubstrings[node->id] += effectiveLength(child) + subtreeSubstrings[child->id];
+            }
+        }
+        substringCountsBuilt = true;
+    }
+
+    // [EXTRA] Número total de substrings distintos (no vacíos, sin '$') del texto.
+    long long distinctSubstringCount() {
+        buildSubstringCounts();
+        return subtreeSubstrings[root->id];
+    }
+
+    // [EXTRA] k-ésimo substring distinto en orden lexicográfico (k base 1), como (offset, longitud)
+    // de una de sus ocurrencias en el texto. Retorna (-1, 0) si k está fuera de rango.
+    // Costo: O(profundidad en nodos × Σ).
+    pair<int, int> kthSubstring(long long k) {
+        buildSubstringCounts();
+        if (k < 1 || k > subtreeSubstrings[root->id])
+            return {-1, 0};
+        Node *node = root;
+        while (true) {
+            Node *next = nullptr;
+            for (const auto &child: node->children) {
+                if (child == nullptr)
+                    continue;
+                long long edgeStrings = effectiveLength(child);
+                if (k <= edgeStrings)
+                    return {labelStart(child), node->stringDepth + static_cast<int>(k)};
+                k -= edgeStrings;
+                if (k <= subtreeSubstrings[child->id]) {
+                    next = child;
+                    break;
+                }
+                k -= subtreeSubstrings[child->id];
+            }
+            node = next;
+        }
+    }
+
+    // [EXTRA] Rank de 'pattern': número de substrings distintos del texto que son ≤ pattern en orden
+    // lexicográfico. Si 'pattern' aparece en el texto, es su posición k y kthSubstring(k) lo recupera.
+    // Retorna -1 si 'pattern' contiene caracteres fuera del alfabeto. Costo: O(|pattern| + profundidad × Σ).
+    long long rankOf(const string &pattern) {
+        buildSubstringCounts();
+        long long rank = 0;
+        Node *node = root;
+        int pos = 0;
+        const int m = static_cast<int>(pattern.size());
+        while (pos < m) {
+            int idx = alphabetRank(pattern[pos]);
+            if (idx < 0 || idx >= ALPHABET_SIZE)
+                return -1;
+            // Todos los substrings que continúan con un carácter menor son menores que 'pattern'.
+            for (int c = 0; c < idx; c++) {
+                Node *child = node->children[c];
+                if (child != nullptr)
+                    rank += effectiveLength(child) + subtreeSubstrings[child->id];
+            }
+            Node *child = node->children[idx];
+            if (child == nullptr)
+                return rank;
+            const int edgeStrings = effectiveLength(child);
+            for (int t = 0; t < edgeStrings; t++) {
+                if (pos == m)
+                    return rank; // Lo que sigue en la arista extiende a 'pattern': es mayor
+                int edgeIdx = alphabetRank(text[child->start + t]);
+                int patternIdx = alphabetRank(pattern[pos]);
+                if (patternIdx < 0 || patternIdx >= ALPHABET_SIZE)
+                    return -1;
+                if (edgeIdx == patternIdx) {
+                    rank++; // pattern[0..pos] es prefijo de 'pattern', por lo tanto ≤ pattern
+                    pos++;
+                } else {
+                    if (edgeIdx < patternIdx)
+                        rank += (edgeStrings - t) + subtreeSubstrings[child->id];
+                    return rank;
+                }
+            }
+            if (edgeStrings < child->edgeLength())
+                return rank; // Hoja: después solo queda '$'
+            node = child;
+        }
+        return rank;
+    }
+
+    // [EXTRA] Posición (base 0) de una ocurrencia del substring del locus; -1 si no se encontró.
+    int locusOffset(const Locus &locus) {
+        if (!locus.found())
+            return -1;
+        return locus.node == root ? 0 : labelStart(locus.node);
+    }
+
+    // [EXTRA] Posiciones (base 0, ordenadas) de todas las ocurrencias del substring del locus.
+    vector<int> locusOccurrences(const Locus &locus) {
+        vector<int> matches;
+        if (!locus.found())
+            return matches;
+        getLeafIndices(locus.node, matches);
+        sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    // ======================= [EXTRA] Matching por diccionario =======================
+    // Recorrido iterativo en orden de hijos que numera las hojas: las hojas bajo un nodo quedan
+    // contiguas en leafOrder a partir de leafBegin, así que las ocurrencias de cualquier locus son
+    // el span [leafBegin, leafBegin + leafCount).
+    void buildLeafOrder() {
+        if (leafOrderBuilt)
+            return;
+        leafOrder.clear();
+        leafOrder.reserve(root->leafCount);
+        leafBegin.assign(nodeCount, 0);
+        vector<Node *> stack = {root};
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            leafBegin[node->id] = static_cast<int>(leafOrder.size());
+            if (isLeafNode(node)) {
+                if (node != root)
+                    leafOrder.push_back(node->suffixIndex);
+                continue;
+            }
+            for (int c = ALPHABET_SIZE - 1; c >= 0; c--) {
+                if (node->children[c] != nullptr)
+                    stack.push_back(node->children[c]);
+            }
+        }
+        leafOrderBuilt = true;
+    }
+
+    // [EXTRA] Posiciones de inicio de sufijo en orden lexicográfico ('$' después de las letras).
+    const vector<int> &getLeafOrder() {
+        buildLeafOrder();
+        return leafOrder;
+    }
+
+    // [EXTRA] Busca todos los patrones a la vez recorriendo su trie en paralelo con el árbol. El trie
+    // no se materializa: los patrones ordenados son su recorrido en preorden, y el camino actual es la
+    // pila de loci del patrón anterior. Cada patrón descarta los loci más allá del LCP con el anterior
+    // y avanza con extendRight solo desde ahí, de modo que cada prefijo compartido se compara una sola
+    // vez. Costo: O(Σ|P| log k) para ordenar más O(tamaño del trie) en el árbol. result[k] corresponde
+    // a patterns[k].
+    vector<DictionaryMatch> matchDictionary(const vector<string> &patterns) {
+        buildLeafOrder();
+        vector<int> order(patterns.size());
+        for (size_t k = 0; k < order.size(); k++)
+            order[k] = static_cast<int>(k);
+        sort(order.begin(), order.end(), [&patterns](int a, int b) { return patterns[a] < patterns[b]; });
+
+        vector<DictionaryMatch> result(patterns.size(), DictionaryMatch{{nullptr, 0}, 0, 0});
+        vector<Locus> path = {rootLocus()}; // path[d] = locus de los primeros d caracteres del patrón anterior
+        const string *previous = nullptr;
+        for (int k: order) {
+            const string &pattern = patterns[k];
+            size_t common = 0;
+            if (previous != nullptr) {
+                size_t limit = min(previous->size(), pattern.size());
+                while (common < limit && (*previous)[common] == pattern[common])
+                    common++;
+            }
+            path.resize(min(path.size(), common + 1)); // Si el anterior no apareció, path es más corto
+            while (path.size() <= pattern.size()) {
+                Locus next = extendRight(path.back(), pattern[path.size() - 1]);
+                if (!next.found())
+                    break; // Ningún patrón con este prefijo aparece
+                path.push_back(next);
+            }
+            if (path.size() == pattern.size() + 1) {
+                const Locus &current = path.back();
+                result[k] = {current, leafBegin[current.node->id], current.node->leafCount};
+            }
+            previous = &pattern;
+        }
+        return result;
+    }
+
+    // [EXTRA] Posiciones (base 0, ordenadas) de las ocurrencias de un resultado de matchDictionary.
+    vector<int> dictionaryOccurrences(const DictionaryMatch &match) {
+        buildLeafOrder();
+        vector<int> matches(leafOrder.begin() + match.begin, leafOrder.begin() + match.begin + match.count);
+        sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    // [EXTRA] Compara matchDictionary contra findAllMatches por patrón sobre los mismos patrones.
+    // El orden de hojas se construye antes de medir, ya que se amortiza entre consultas.
+    DictionaryBenchmark benchmarkDictionary(const vector<string> &patterns) {
+        buildLeafOrder();
+        DictionaryBenchmark report{};
+        report.patterns = static_cast<int>(patterns.size());
+        auto begin = chrono::steady_clock::now();
+        vector<DictionaryMatch> matches = matchDictionary(patterns);
+        report.dictionarySeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        for (const DictionaryMatch &match: matches) {
+            vector<int> positions = dictionaryOccurrences(match);
+            report.occurrences += static_cast<long long>(positions.size());
+        }
+        report.dictionaryWithOccurrencesSeconds =
+                chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        begin = chrono::steady_clock::now();
+        for (const string &pattern: patterns)
+            findAllMatches(pattern);
+        report.findAllMatchesSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        report.patternsPerSecond = report.dictionarySeconds > 0 ? report.patterns / report.dictionarySeconds : 0;
+        report.speedup = report.dictionaryWithOccurrencesSeconds > 0
+                             ? report.findAllMatchesSeconds / report.dictionaryWithOccurrencesSeconds
+                             : 0;
+        return report;
+    }
+
+    // ======================= [EXTRA] Longest previous factor (LPF) =======================
+    // LPF[i] = longitud del prefijo más largo de text[i..] que también empieza en alguna j < i, y
+    // prevOcc[i] = esa j (-1 si LPF[i] = 0). Con minLeaf (menor posición del subárbol): los nodos con
+    // minLeaf = i forman una cadena desde la hoja de i hacia arriba, y el padre u de su nodo más alto
+    // es el ancestro más profundo con alguna ocurrencia anterior, así que LPF[i] = stringDepth(u) y
+    // prevOcc[i] = minLeaf(u). Cada nodo es el más alto de a lo sumo una cadena: O(n) en total.
+    // Los arreglos cubren el texto sin el '$' final (n - 1 posiciones). 'prevOcc' puede ser nullptr.
+    // Retorna false en un árbol disperso (no contiene todos los sufijos).
+    bool computeLPF(int *lpf, int *prevOcc) {
+        if (sparse)
+            return false;
+        const int length = static_cast<int>(text.size()) - 1;
+        if (length <= 0)
+            return true;
+        buildMinLeaf();
+        lpf[0] = 0; // La cadena de la posición 0 llega hasta la raíz
+        if (prevOcc != nullptr)
+            prevOcc[0] = -1;
+        vector<Node *> stack = {root};
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            for (const auto &child: node->children) {
+                if (child == nullptr)
+                    continue;
+                if (minLeaf[child->id] != minLeaf[node->id] && minLeaf[child->id] < length) {
+                    lpf[minLeaf[child->id]] = node->stringDepth;
+                    if (prevOcc != nullptr)
+                        prevOcc[minLeaf[child->id]] = node == root ? -1 : minLeaf[node->id];
+                }
+                if (!isLeafNode(child))
+                    stack.push_back(child);
+            }
+        }
+        return true;
+    }
+
+    // [EXTRA] LPF y prevOcc en vectores nuevos (ambos vacíos en un árbol disperso).
+    pair<vector<int>, vector<int> > longestPreviousFactor() {
+        const int length = sparse ? 0 : max(static_cast<int>(text.size()) - 1, 0);
+        vector<int> lpf(length), prevOcc(length);
+        computeLPF(lpf.data(), prevOcc.data());
+        return {lpf, prevOcc};
+    }
+
+    // [EXTRA] Escribe LPF seguido de prevOcc (n - 1 enteros de 32 bits cada uno, en el orden de bytes
+    // del host) en 'path'. En sistemas POSIX el archivo se dimensiona y se mapea en memoria, y
+    // computeLPF escribe directamente en el mapeo, sin copias del tamaño del texto en el heap.
+    bool writeLPFFile(const string &path) {
+        if (sparse)
+            return false;
+        const size_t length = text.size() > 0 ? text.size() - 1 : 0;
+        const size_t bytes = 2 * length * sizeof(int);
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        if (bytes == 0) {
+            close(fd);
+            return true;
+        }
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close(fd);
+            return false;
+        }
+        void *mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+            return false;
+        int *values = static_cast<int *>(mapping);
+        computeLPF(values, values + length);
+        bool synced = msync(mapping, bytes, MS_SYNC) == 0;
+        munmap(mapping, bytes);
+        return synced;
+#else
+        pair<vector<int>, vector<int> > arrays = longestPreviousFactor();
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char *>(arrays.first.data()), arrays.first.size() * sizeof(int));
+        out.write(reinterpret_cast<const char *>(arrays.second.data()), arrays.second.size() * sizeof(int));
+        return static_cast<bool>(out);
+#endif
+    }
+
+    // [EXTRA] Factorización LZ77 greedy (la fuente de una frase puede solaparse con la propia
+    // frase) derivada de LPF: cada frase tiene longitud max(1, LPF[i]).
+    vector<LZ77Phrase> lz77Factorize() {
+        pair<vector<int>, vector<int> > arrays = longestPreviousFactor();
+        vector<LZ77Phrase> phrases;
+        const int length = static_cast<int>(arrays.first.size());
+        for (int i = 0; i < length;) {
+            int l = arrays.first[i];
+            phrases.push_back(l > 0 ? LZ77Phrase{i, l, arrays.second[i]} : LZ77Phrase{i, 1, -1});
+            i += max(l, 1);
+        }
+        return phrases;
+    }
+
+    // ======================= [EXTRA] LRS y SUS restringidos a una ventana =======================
+    // Rangos de los sufijos en orden de hojas y sparse table sobre los LCP de hojas adyacentes: en un
+    // DFS, el LCP de dos hojas es el mínimo de los LCP adyacentes entre ellas, y el LCP entre la última
+    // hoja de un hijo y la primera del siguiente es el stringDepth del padre. O(n log n) memoria.
+    void buildLCPIndex() {
+        if (!lcpTable.empty())
+            return;
+        buildLeafOrder();
+        const int leaves = static_cast<int>(leafOrder.size());
+        suffixRank.assign(text.size(), -1);
+        for (int r = 0; r < leaves; r++)
+            suffixRank[leafOrder[r]] = r;
+        vector<int> adjacent(max(leaves - 1, 1), 0);
+        vector<Node *> stack = {root};
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            bool first = true;
+            for (const auto &child: node->children) {
+                if (child == nullptr)
+                    continue;
+                if (!first)
+                    adjacent[leafBegin[child->id] - 1] = node->stringDepth;
+                first = false;
+                if (!isLeafNode(child))
+                    stack.push_back(child);
+            }
+        }
+        lcpTable.push_back(adjacent);
+        for (int k = 1; (1 << k) <= static_cast<int>(adjacent.size()); k++) {
+            const vector<int> &previous = lcpTable[k - 1];
+            vector<int> level(adjacent.size() - (1 << k) + 1);
+            for (size_t r = 0; r < level.size(); r++)
+                level[r] = min(previous[r], previous[r + (1 << (k - 1))]);
+            lcpTable.push_back(level);
+        }
+    }
+
+    // [EXTRA] Substring más largo que aparece al menos dos veces dentro de text[a..b] (ambos inclusive,
+    // sin contar el '$' final). Las posiciones de la ventana se ordenan por rango; "hay una repetición
+    // de longitud l" equivale a que dos posiciones p con p + l - 1 ≤ b, consecutivas entre ellas en ese
+    // orden, tengan LCP ≥ l (mínimo de los LCP adyacentes intermedios). Esa propiedad es monótona en l,
+    // así que se busca binariamente: O(w log w) con w = b - a + 1, sin construir un árbol de la ventana.
+    // Asintóticamente no gana a reconstruir el árbol de la ventana (O(w)); la ventaja es de constantes,
+    // medida con benchmarkWindowQueries.
+    string longestRepeatedSubstring(int a, int b) {
+        int offset = 0, length = 0;
+        if (!windowQuery(a, b))
+            return "";
+        vector<int> sorted, adjacent;
+        sortWindow(a, b, sorted, adjacent);
+        // Posición de una repetición de longitud l dentro de la ventana (-1 si no hay).
+        auto repeatAt = [&](int l) {
+            int runMin = INT_MAX;
+            bool previous = false;
+            for (size_t k = 0; k < sorted.size(); k++) {
+                if (k > 0)
+                    runMin = min(runMin, adjacent[k - 1]);
+                if (sorted[k] + l - 1 > b)
+                    continue;
+                if (previous && runMin >= l)
+                    return sorted[k];
+                previous = true;
+                runMin = INT_MAX;
+            }
+            return -1;
+        };
+        int low = 1, high = b - a; // La repetición más larga posible tiene longitud w - 1
+        while (low <= high) {
+            int mid = low + (high - low) / 2;
+            int found = repeatAt(mid);
+            if (found >= 0) {
+                offset = found;
+                length = mid;
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+        return text.substr(offset, length);
+    }
+
+    // [EXTRA] Compara longestRepeatedSubstring(a, b) y shortestUniqueSubstring(a, b) con construir el
+    // árbol de text[a..b] + '$' y consultarlo, en 'queries' ventanas aleatorias de 'windowLength'
+    // caracteres. Ambos métodos son O(w log w) / O(w) por consulta; la diferencia está en las constantes
+    // (ordenar w rangos contra asignar ~2w nodos) y en que el índice se construye una sola vez.
+    WindowQueryBenchmark benchmarkWindowQueries(int windowLength, int queries, uint64_t seed = 42) {
+        WindowQueryBenchmark report{};
+        const int n = static_cast<int>(text.size()) - 1;
+        windowLength = max(1, min(windowLength, n));
+        report.windowLength = windowLength;
+        report.queries = max(queries, 0);
+        if (sparse || n <= 0)
+            return report;
+        auto begin = chrono::steady_clock::now();
+        buildLCPIndex();
+        report.indexSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        mt19937_64 random(seed);
+        vector<int> starts(report.queries);
+        for (int &a: starts)
+            a = static_cast<int>(random() % (n - windowLength + 1));
+        vector<size_t> lrs(report.queries), sus(report.queries);
+        auto elapsedNanos = [&begin](int count) {
+            double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            return count > 0 ? nanos / count : 0.0;
+        };
+
+        begin = chrono::steady_clock::now();
+        for (int q = 0; q < report.queries; q++)
+            lrs[q] = longestRepeatedSubstring(starts[q], starts[q] + windowLength - 1).size();
+        report.windowLrsNanos = elapsedNanos(report.queries);
+        begin = chrono::steady_clock::now();
+        for (int q = 0; q < report.queries; q++)
+            sus[q] = shortestUniqueSubstring(starts[q], starts[q] + windowLength - 1).size();
+        report.windowSusNanos = elapsedNanos(report.queries);
+
+        begin = chrono::steady_clock::now();
+        for (int q = 0; q < report.queries; q++) {
+            SuffixTree window(text.substr(starts[q], windowLength) + "$", normalization);
+            report.mismatches += window.longestRepeatedSubstring().size() != lrs[q];
+        }
+        report.rebuildLrsNanos = elapsedNanos(report.queries);
+        begin = chrono::steady_clock::now();
+        for (int q = 0; q < report.queries; q++) {
+            SuffixTree window(text.substr(starts[q], windowLength) + "$", normalization);
+            report.mismatches += window.shortestUniqueSubstring().size() != sus[q];
+        }
+        report.rebuildSusNanos = elapsedNanos(report.queries);
+        report.lrsSpeedup = report.windowLrsNanos > 0 ? report.rebuildLrsNanos / report.windowLrsNanos : 0;
+        report.susSpeedup = report.windowSusNanos > 0 ? report.rebuildSusNanos / report.windowSusNanos : 0;
+        return report;
+    }
+
+    // [EXTRA] Substring más corto que aparece exactamente una vez dentro de text[a..b]. Un substring de
+    // longitud l en p es único si, entre las posiciones p' con p' + l - 1 ≤ b, sus vecinas en orden de
+    // rango tienen LCP < l con p. Si hay uno de longitud l también hay uno de longitud l + 1 (se extiende
+    // a la derecha o, en el borde, a la izquierda), así que se busca binariamente la mínima.
+    string shortestUniqueSubstring(int a, int b) {
+        if (!windowQuery(a, b))
+            return "";
+        vector<int> sorted, adjacent;
+        sortWindow(a, b, sorted, adjacent);
+        vector<int> leftLcp(sorted.size()); // LCP con la posición elegible anterior (-1 si no hay)
+        auto uniqueAt = [&](int l) {
+            int runMin = INT_MAX;
+            int previous = -1; // Índice en 'sorted' de la posición elegible anterior
+            for (size_t k = 0; k < sorted.size(); k++) {
+                if (k > 0)
+                    runMin = min(runMin, adjacent[k - 1]);
+                if (sorted[k] + l - 1 > b)
+                    continue;
+                int left = previous >= 0 ? runMin : -1;
+                // La posición anterior es única si su LCP con ambas vecinas es menor que l.
+                if (previous >= 0 && leftLcp[previous] < l && left < l)
+                    return sorted[previous];
+                leftLcp[k] = left;
+                previous = static_cast<int>(k);
+                runMin = INT_MAX;
+            }
+            if (previous >= 0 && leftLcp[previous] < l)
+                return sorted[previous];
+            return -1;
+        };
+        int offset = a, length = b - a + 1; // La ventana completa siempre es única
+        int low = 1, high = b - a;
+        while (low <= high) {
+            int mid = low + (high - low) / 2;
+            int found = uniqueAt(mid);
+            if (found >= 0) {
+                offset = found;
+                length = mid;
+                high = mid - 1;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return text.substr(offset, length);
+    }
+
+    // ======================= [EXTRA] LCE y periodicidad de substrings =======================
+    // [EXTRA] Longest common extension: longitud del prefijo común más largo de text[a..] y text[b..]
+    // (sin el '$'), en O(1) con la sparse table de LCP.
+    int longestCommonExtension(int a, int b) {
+        const int n = static_cast<int>(text.size());
+        if (sparse || a < 0 || b < 0 || a >= n - 1 || b >= n - 1)
+            return 0;
+        if (a == b)
+            return n - 1 - a;
+        buildLCPIndex();
+        int r1 = suffixRank[a], r2 = suffixRank[b];
+        return lcpOfRanks(min(r1, r2), max(r1, r2));
+    }
+
+    // [EXTRA] Período más corto de S = text[i..j] (|S| si no tiene otro); -1 si el rango no es válido.
+    // p es período sii S tiene un borde de longitud |S| - p, así que se busca el borde más largo por
+    // niveles k (bordes de longitud ℓ ∈ [2^k, 2^(k+1))), de mayor a menor. Un borde así empieza con
+    // P = text[i .. i + 2^k - 1], y sus inicios posibles forman un rango de longitud 2^k = |P|, donde las
+    // ocurrencias de P forman una progresión aritmética (primera, segunda y última se obtienen con range
+    // successor/predecessor sobre el intervalo de hojas de locus(i, i + 2^k - 1)). Con diferencia d
+    // (período de P) y los extremos E1, E2 de las corridas de período d que empiezan en i y en la primera
+    // ocurrencia, el borde del nivel se decide con O(1) LCE:
+    //  - si text[q..j] queda dentro de la corrida (j < E2), q es borde sii j - q + 1 ≤ E1 - i;
+    //  - si no, ambas cadenas rompen el período d y solo puede ser borde q = E2 - (E1 - i).
+    // Costo: O(log |S| · log² n) por consulta.
+    int shortestPeriod(int i, int j) {
+        if (!windowQuery(i, j))
+            return -1;
+        buildLocusIndex();
+        buildRangeSuccessor();
+        const int length = j - i + 1;
+        int k = 0;
+        while ((2 << k) <= length - 1)
+            k++;
+        for (; length > 1 && k >= 0; k--) {
+            const int shortest = 1 << k, longest = min((2 << k) - 1, length - 1);
+            const int from = j - longest + 1, to = j - shortest + 1; // Inicios q de bordes del nivel
+            Node *node = locus(i, i + shortest - 1).node;
+            const int lo = leafBegin[node->id], hi = lo + node->leafCount;
+            const int first = rangeNeighbor(lo, hi, from, true);
+            if (first < 0 || first > to)
+                continue;
+            const int last = rangeNeighbor(lo, hi, to, false);
+            int border = -1;
+            if (first == last) {
+                if (longestCommonExtension(i, first) >= j - first + 1)
+                    border = first;
+            } else {
+                const int d = rangeNeighbor(lo, hi, first + 1, true) - first;
+                const int e1 = i + d + longestCommonExtension(i, i + d);
+                const int e2 = first + d + longestCommonExtension(first, first + d);
+                if (j < e2) {
+                    int bound = max(j + 1 - (e1 - i), first);
+                    int q = first + (bound - first + d - 1) / d * d;
+                    if (q <= last)
+                        border = q;
+                } else {
+                    int q = e2 - (e1 - i);
+                    if (q >= first && q <= last && (q - first) % d == 0 &&
+                        longestCommonExtension(i, q) >= j - q + 1)
+                        border = q;
+                }
+            }
+            if (border >= 0)
+                return border - i; // Período = |S| - (j - border + 1)
+        }
+        return length;
+    }
+
+    // [EXTRA] true si text[i..j] es periódico: su período más corto es a lo sumo la mitad de su longitud.
+    bool isPeriodic(int i, int j) {
+        int period = shortestPeriod(i, j);
+        return period > 0 && 2 * period <= j - i + 1;
+    }
+
+    // [EXTRA] shortestPeriod para un lote de rangos (i, j), repartidos entre hilos. Los índices se
+    // construyen antes de lanzar los hilos; después las consultas solo leen.
+    vector<int> shortestPeriods(const vector<pair<int, int> > &queries, unsigned threads = 0) {
+        vector<int> periods(queries.size(), -1);
+        if (sparse)
+            return periods;
+        buildLCPIndex();
+        buildLocusIndex();
+        buildRangeSuccessor();
+        parallelChunks(static_cast<int>(queries.size()), resolveThreads(threads), [&](int from, int to, unsigned) {
+            for (int q = from; q < to; q++)
+                periods[q] = shortestPeriod(queries[q].first, queries[q].second);
+        });
+        return periods;
+    }
+
+    // ======================= [EXTRA] Intersección de dos suffix trees =======================
+    // Recorre ambos árboles en paralelo, sin construir un árbol generalizado: cada estado es un par de
+    // loci con el mismo substring, donde al menos uno está en un nodo explícito. Para cada carácter se
+    // toma el hijo (o la continuación de la arista) en cada árbol y se comparan ambas aristas hasta que
+    // una termina o dejan de coincidir; eso da un CommonSegment, y si se llegó a un nodo se continúa
+    // desde ahí. Cada substring común aparece en exactamente un segmento y el costo es proporcional al
+    // número de caracteres comparados (O(|A| + |B|) estados de ramificación más las aristas).
+    // visit(segment) se llama a medida que se descubren los segmentos con maxLength ≥ minLength, sin
+    // acumularlos (el '$' nunca es parte de un substring común).
+    template<typename Visitor>
+    void commonSubstrings(SuffixTree &other, Visitor visit, int minLength = 1) {
+        struct State {
+            Node *self;
+            Node *other;
+            int depth; // Longitud del substring común; el locus en cada árbol es (nodo, depth)
+        };
+        // Rank del carácter en la profundidad 'depth' (base 0) del path label de 'node' en el texto 'owner'
+        // (cada árbol compara con su propia normalización).
+        auto rankAt = [](const SuffixTree &owner, Node *node, int depth) {
+            return owner.alphabetRank(owner.text[node->start + depth - (node->stringDepth - node->edgeLength())]);
+        };
+        vector<State> stack = {{root, other.root, 0}};
+        while (!stack.empty()) {
+            State state = stack.back();
+            stack.pop_back();
+            const bool selfAtNode = state.depth == state.self->stringDepth;
+            const bool otherAtNode = state.depth == state.other->stringDepth;
+            for (int c = ALPHABET_SIZE - 2; c >= 0; c--) { // Sin '$'
+                Node *a = selfAtNode ? state.self->children[c]
+                                     : (rankAt(*this, state.self, state.depth) == c ? state.self : nullptr);
+                Node *b = otherAtNode ? state.other->children[c]
+                                      : (rankAt(other, state.other, state.depth) == c ? state.other : nullptr);
+                if (a == nullptr || b == nullptr)
+                    continue;
+                int depth = state.depth + 1;
+                while (depth < a->stringDepth && depth < b->stringDepth) {
+                    int next = rankAt(*this, a, depth);
+                    if (next == ALPHABET_SIZE - 1 || next != rankAt(other, b, depth))
+                        break;
+                    depth++;
+                }
+                const bool reachedSelf = depth == a->stringDepth && !isLeafNode(a);
+                const bool reachedOther = depth == b->stringDepth && !isLeafNode(b);
+                if (depth >= minLength) {
+                    visit(CommonSegment{labelStart(a), other.labelStart(b), max(state.depth + 1, minLength), depth,
+                                        a->leafCount, b->leafCount, reachedSelf || reachedOther});
+                }
+                if (reachedSelf || reachedOther)
+                    stack.push_back({a, b, depth});
+            }
+        }
+    }
+
+    // [EXTRA] Escribe los segmentos comunes como líneas JSON a medida que se encuentran.
+    void writeCommonSubstrings(SuffixTree &other, ostream &out, int minLength = 1) {
+        commonSubstrings(other, [&](const CommonSegment &segment) {
+            out << "{\"substring\":\"" << text.substr(segment.offset, segment.maxLength)
+                << "\",\"minLength\":" << segment.minLength << ",\"offset\":" << segment.offset
+                << ",\"otherOffset\":" << segment.otherOffset << ",\"count\":" << segment.countSelf
+                << ",\"otherCount\":" << segment.countOther
+                << ",\"branching\":" << (segment.branching ? "true" : "false") << "}\n";
+        }, minLength);
+    }
+
+    // ======================= [EXTRA] Matching statistics =======================
+    // ms[q] = longitud del prefijo más largo de query[q..] que aparece en el texto y, si 'positions' no es
+    // nullptr, (*positions)[q] = una posición del texto donde aparece (-1 si ms[q] = 0).
+    // La consulta se divide en bloques contiguos, uno por hilo. Cada bloque resincroniza su primera
+    // posición descendiendo desde la raíz, lo cual da exactamente ms[from] (el valor no depende de la
+    // posición anterior), y continúa con suffix links; por eso no hay efectos de borde y el resultado es
+    // idéntico al secuencial. El costo extra por bloque es O(ms[from]).
+    vector<int> matchingStatistics(const string &query, unsigned threads = 0, vector<int> *positions = nullptr) {
+        const int m = static_cast<int>(query.size());
+        vector<int> ms(m, 0);
+        if (positions != nullptr)
+            positions->assign(m, -1);
+        parallelChunks(m, resolveThreads(threads), [&](int from, int to, unsigned) {
+            matchingStatisticsRange(query, from, to, [&](int q, const Locus &locus) {
+                ms[q] = locus.depth;
+                if (positions != nullptr && locus.depth > 0)
+                    (*positions)[q] = locusOffset(locus);
+            });
+        });
+        return ms;
+    }
+
+    // ======================= [EXTRA] Maximal exact matches (MEM) y maximal unique matches (MUM) =======================
+    // Estilo MUMmer: la consulta se recorre contra el árbol de la referencia con matching statistics.
+    // Para cada posición q con matching statistic L y locus (v, L):
+    //  - cada hoja r bajo v da un match de longitud exactamente L (query[q + L] ya no coincide);
+    //  - cada ancestro u de v con stringDepth(u) ≥ minLength da matches de longitud stringDepth(u) con
+    //    las hojas de sus otros hijos (divergen justo después de label(u)).
+    // Esos son los matches maximales a la derecha; se reportan los que además lo son a la izquierda.
+    // La consulta se divide en bloques contiguos procesados en paralelo; cada bloque arranca desde la
+    // raíz, por lo que el resultado es idéntico al secuencial. Resultado ordenado por (queryPos, refPos).
+    vector<MaximalMatch> findMaximalExactMatches(const string &query, int minLength, unsigned threads = 0) {
+        minLength = max(minLength, 1);
+        const unsigned parts = resolveThreads(threads);
+        vector<vector<MaximalMatch> > partial(parts);
+        parallelChunks(static_cast<int>(query.size()), parts, [&](int from, int to, unsigned t) {
+            vector<int> leaves;
+            matchingStatisticsRange(query, from, to, [&](int q, const Locus &locus) {
+                if (locus.depth < minLength)
+                    return;
+                leaves.clear();
+                getLeafIndices(locus.node, leaves);
+                reportLeftMaximal(query, q, locus.depth, leaves, partial[t]);
+                Node *excluded = locus.node;
+                for (Node *u = excluded->parent; u != nullptr && u->stringDepth >= minLength; u = u->parent) {
+                    leaves.clear();
+                    for (const auto &child: u->children) {
+                        if (child != nullptr && child != excluded)
+                            getLeafIndices(child, leaves);
+                    }
+                    reportLeftMaximal(query, q, u->stringDepth, leaves, partial[t]);
+                    excluded = u;
+                }
+            });
+        });
+        vector<MaximalMatch> result;
+        for (vector<MaximalMatch> &p: partial) {
+            sort(p.begin(), p.end());
+            result.insert(result.end(), p.begin(), p.end());
+        }
+        return result;
+    }
+
+    // [EXTRA] Maximal unique matches: MEMs que aparecen una sola vez en la referencia y una sola vez en
+    // la consulta. Un match único en la referencia tiene su locus en la arista de una hoja r; otra
+    // ocurrencia en la consulta caería en la misma hoja con matching statistic ≥ L. Por eso, de cada
+    // hoja solo puede salir un MUM: el candidato de mayor L, si es el único con esa longitud.
+    vector<MaximalMatch> findMaximalUniqueMatches(const string &query, int minLength, unsigned threads = 0) {
+        minLength = max(minLength, 1);
+        const unsigned parts = resolveThreads(threads);
+        vector<vector<MaximalMatch> > partial(parts);
+        parallelChunks(static_cast<int>(query.size()), parts, [&](int from, int to, unsigned t) {
+            matchingStatisticsRange(query, from, to, [&](int q, const Locus &locus) {
+                if (locus.depth >= minLength && isLeafNode(locus.node))
+                    partial[t].push_back({locus.node->suffixIndex, q, locus.depth});
+            });
+        });
+        vector<MaximalMatch> candidates;
+        for (const vector<MaximalMatch> &p: partial)
+            candidates.insert(candidates.end(), p.begin(), p.end());
+        // Agrupa por hoja de la referencia, con el candidato más largo primero.
+        sort(candidates.begin(), candidates.end(), [](const MaximalMatch &a, const MaximalMatch &b) {
+            if (a.refPos != b.refPos)
+                return a.refPos < b.refPos;
+            return a.length > b.length;
+        });
+        vector<MaximalMatch> result;
+        for (size_t k = 0; k < candidates.size(); k++) {
+            if (k > 0 && candidates[k].refPos == candidates[k - 1].refPos)
+                continue;
+            const MaximalMatch &best = candidates[k];
+            bool repeated = k + 1 < candidates.size() && candidates[k + 1].refPos == best.refPos &&
+                            candidates[k + 1].length == best.length;
+            bool leftMaximal = best.queryPos == 0 || best.refPos == 0 ||
+                               !sameChar(query[best.queryPos - 1], text[best.refPos - 1]);
+            if (!repeated && leftMaximal)
+                result.push_back(best);
+        }
+        sort(result.begin(), result.end());
+        return result;
+    }
+
+    // [EXTRA] Benchmark de MEM/MUM sobre datos sintéticos: referencia aleatoria de 'referenceLength'
+    // caracteres sobre {A, C, G, T} y consulta armada con ventanas de la referencia (hasta 10000
+    // caracteres cada una) con sustituciones en una fracción 'mutationRate' de las posiciones, como
+    // lecturas alineadas contra un genoma. Cada búsqueda se mide con 1 hilo y con 'threads' hilos.
+    static MaximalMatchBenchmark benchmarkMaximalMatches(int referenceLength, int queryLength, int minLength,
+                                                         double mutationRate = 0.01, unsigned threads = 0,
+                                                         uint64_t seed = 42) {
+        const char bases[] = {'A', 'C', 'G', 'T'};
+        mt19937_64 random(seed);
+        referenceLength = max(referenceLength, 1);
+        string reference(referenceLength, 'A');
+        for (char &c: reference)
+            c = bases[random() % 4];
+        string query;
+        query.reserve(max(queryLength, 0));
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        while (static_cast<int>(query.size()) < queryLength) {
+            int window = min({referenceLength, 10000, queryLength - static_cast<int>(query.size())});
+            int start = static_cast<int>(random() % (referenceLength - window + 1));
+            for (int k = 0; k < window; k++)
+                query.push_back(coin(random) < mutationRate ? bases[random() % 4] : reference[start + k]);
+        }
+
+        MaximalMatchBenchmark report{};
+        report.referenceLength = referenceLength;
+        report.queryLength = static_cast<int>(query.size());
+        report.threads = resolveThreads(threads);
+        auto begin = chrono::steady_clock::now();
+        SuffixTree tree(reference + "$");
+        report.buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        auto measure = [&begin]() {
+            return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        };
+
+        begin = chrono::steady_clock::now();
+        report.mems = static_cast<long long>(tree.findMaximalExactMatches(query, minLength, 1).size());
+        report.memSequentialSeconds = measure();
+        begin = chrono::steady_clock::now();
+        tree.findMaximalExactMatches(query, minLength, report.threads);
+        report.memSeconds = measure();
+        begin = chrono::steady_clock::now();
+        report.mums = static_cast<long long>(tree.findMaximalUniqueMatches(query, minLength, 1).size());
+        report.mumSequentialSeconds = measure();
+        begin = chrono::steady_clock::now();
+        tree.findMaximalUniqueMatches(query, minLength, report.threads);
+        report.mumSeconds = measure();
+
+        report.memSpeedup = report.memSeconds > 0 ? report.memSequentialSeconds / report.memSeconds : 0;
+        report.mumSpeedup = report.mumSeconds > 0 ? report.mumSequentialSeconds / report.mumSeconds : 0;
+        report.queryMBps = report.memSeconds > 0 ? report.queryLength / 1e6 / report.memSeconds : 0;
+        return report;
+    }
+
+    // ======================= [EXTRA] Entropía empírica de orden k =======================
+    // H_k = (1/n) Σ_{|w| = k} Σ_c n_wc · log2(n_w / n_wc), donde n_wc es el número de ocurrencias de w
+    // seguidas por c. Los contextos que terminan dentro de una arista tienen un único sucesor y aportan
+    // 0, así que solo contribuyen los nodos internos con stringDepth = k, usando el leafCount de cada
+    // hijo como n_wc (se excluye el hijo '$', que marca el final del texto). Una sola pasada calcula
+    // todos los k; n = |text| - 1 (sin '$').
+    void buildEntropyProfile() {
+        if (!entropyByOrder.empty())
+            return;
+        const double n = static_cast<double>(text.size()) - 1;
+        vector<Node *> stack = {root};
+        while (!stack.empty()) {
+            Node *node = stack.back();
+            stack.pop_back();
+            long long total = 0;
+            for (int c = 0; c < ALPHABET_SIZE - 1; c++) {
+                if (node->children[c] != nullptr)
+                    total += node->children[c]->leafCount;
+            }
+            double bits = 0;
+            for (int c = 0; c < ALPHABET_SIZE - 1; c++) {
+                Node *child = node->children[c];
+                if (child != nullptr)
+                    bits += child->leafCount * log2(static_cast<double>(total) / child->leafCount);
+            }
+            if (total > 0) {
+                if (entropyByOrder.size() <= static_cast<size_t>(node->stringDepth))
+                    entropyByOrder.resize(node->stringDepth + 1, 0.0);
+                entropyByOrder[node->stringDepth] += n > 0 ? bits / n : 0.0;
+            }
+            for (const auto &child: node->children) {
+                if (child != nullptr && !isLeafNode(child))
+                    stack.push_back(child);
+            }
+        }
+    }
+
+    // [EXTRA] H_k en bits por símbolo (0 para k mayor que la profundidad máxima de un nodo interno).
+    double empiricalEntropy(int k) {
+        buildEntropyProfile();
+        if (k < 0 || k >= static_cast<int>(entropyByOrder.size()))
+            return 0.0;
+        return entropyByOrder[k];
+    }
+
+    // [EXTRA] H_0, H_1, ..., H_K para todos los órdenes con contribución (calculados en una sola pasada).
+    vector<double> empiricalEntropies() {
+        buildEntropyProfile();
+        return entropyByOrder;
+    }
+
+    // ======================= [EXTRA] Predictor de Markov de orden variable (PPM) =======================
+    // El contexto es un Locus. advanceContext agrega un carácter: si contexto + c no aparece en el
+    // texto, se descarta el primer carácter del contexto con el suffix link (como en matching
+    // statistics) hasta que aparezca, y se acota el orden a maxOrder. En un árbol disperso, descartar
+    // caracteres reinicia el contexto en la raíz (ver suffixLocus).
+    Locus advanceContext(const Locus &context, char c, int maxOrder) {
+        Locus current = context.found() ? context : rootLocus();
+        Locus next = c == '$' ? Locus{nullptr, 0} : extendRight(current, c);
+        while (!next.found()) {
+            if (current.depth == 0)
+                return rootLocus(); // 'c' no aparece en el texto
+            current = suffixLocus(current);
+            next = extendRight(current, c);
+        }
+        while (next.depth > max(maxOrder, 0))
+            next = suffixLocus(next);
+        return next;
+    }
+
+    // [EXTRA] Distribución del siguiente carácter ('A' + i) dado el contexto, con PPM método C y exclusiones:
+    // en cada orden, desde el contexto completo hasta el vacío, los símbolos vistos reciben
+    // count / (n + u) de la masa restante y la fracción u / (n + u) escapa al orden inferior (n =
+    // ocurrencias, u = símbolos distintos no excluidos). Al final, la masa de escape se reparte
+    // uniformemente entre los símbolos nunca vistos. Costo: O(orden × Σ).
+    vector<double> predictNext(const Locus &context) {
+        const int letters = ALPHABET_SIZE - 1;
+        vector<double> probability(letters, 0.0);
+        vector<bool> excluded(letters, false);
+        double escapeMass = 1.0;
+        Locus current = context.found() ? context : rootLocus();
+        while (true) {
+            vector<pair<int, int> > counts; // (símbolo, ocurrencias) no excluidos
+            Node *node = current.node;
+            if (current.depth == node->stringDepth) {
+                for (int c = 0; c < letters; c++) {
+                    if (node->children[c] != nullptr && !excluded[c])
+                        counts.push_back({c, node->children[c]->leafCount});
+                }
+            } else {
+                int c = alphabetRank(text[node->start + current.depth - (node->stringDepth - node->edgeLength())]);
+                if (c < letters && !excluded[c])
+                    counts.push_back({c, node->leafCount});
+            }
+            long long n = 0;
+            for (const auto &entry: counts)
+                n += entry.second;
+            if (n > 0) {
+                const double denominator = static_cast<double>(n + counts.size());
+                for (const auto &entry: counts) {
+                    probability[entry.first] += escapeMass * entry.second / denominator;
+                    excluded[entry.first] = true;
+                }
+                escapeMass *= counts.size() / denominator;
+            }
+            if (current.depth == 0)
+                break;
+            current = suffixLocus(current);
+        }
+        int unseen = static_cast<int>(count_if(excluded.begin(), excluded.end(), [](bool e) { return !e; }));
+        for (int c = 0; c < letters; c++) {
+            if (unseen > 0 && !excluded[c])
+                probability[c] += escapeMass / unseen;
+            else if (unseen == 0)
+                probability[c] /= (1.0 - escapeMass); // Todos vistos: se renormaliza
+        }
+        return probability;
+    }
+
+    // [EXTRA] Longitud de código (bits) de 'sequence' con el predictor, actualizando el contexto en streaming.
+    double codeLength(const string &sequence, int maxOrder) {
+        double bits = 0;
+        Locus context = rootLocus();
+        for (char c: sequence) {
+            int idx = alphabetRank(c);
+            if (idx < 0 || idx >= ALPHABET_SIZE - 1)
+                continue;
+            bits -= log2(predictNext(context)[idx]);
+            context = advanceContext(context, c, maxOrder);
+        }
+        return bits;
+    }
+
+    // ======================= [EXTRA] Perfil de forma del árbol =======================
+    // Recorre el árbol una sola vez y retorna los histogramas de TreeProfile.
+    // La parte superior del árbol se expande en BFS hasta tener suficientes subárboles independientes;
+    // luego cada hilo recorre sus subárboles con una DFS iterativa (sin recursión, apta para árboles
+    // muy profundos) sobre un TreeProfile propio, y al final se combinan los perfiles.
+    // 'threads' = 0 usa thread::hardware_concurrency().
+    TreeProfile profile(unsigned threads = 0) {
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        TreeProfile result;
+        buildSuffixLinkChains();
+
+        // Expansión de la frontera: los nodos expandidos se cuentan en 'result'.
+        vector<ProfileItem> frontier = {{root, 0, 0}};
+        const size_t targetTasks = threads > 1 ? 8 * threads : 1;
+        while (frontier.size() < targetTasks) {
+            vector<ProfileItem> next;
+            bool expanded = false;
+            for (const ProfileItem &item: frontier) {
+                if (isLeafNode(item.node)) {
+                    next.push_back(item);
+                    continue;
+                }
+                profileNode(item, result, &next);
+                expanded = true;
+            }
+            frontier.swap(next);
+            if (!expanded)
+                break;
+        }
+
+        // Reparto de los subárboles de la frontera entre los hilos.
+        vector<TreeProfile> partial(threads);
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([this, t, threads, &frontier, &partial]() {
+                vector<ProfileItem> stack;
+                for (size_t i = t; i < frontier.size(); i += threads) {
+                    stack.push_back(frontier[i]);
+                    while (!stack.empty()) {
+                        ProfileItem item = stack.back();
+                        stack.pop_back();
+                        profileNode(item, partial[t], &stack);
+                    }
+                }
+            });
+        }
+        for (thread &worker: workers)
+            worker.join();
+        for (const TreeProfile &p: partial)
+            result.merge(p);
+        return result;
+    }
+
+    // [EXTRA] Calcula el perfil y lo escribe como JSON en 'out'.
+    void writeProfileJson(ostream &out, unsigned threads = 0) {
+        profile(threads).writeJson(out);
+    }
+
     // ======================= [EXTRA] Funciones de impresión =======================
     // Función para imprimir las aristas del árbol (para depuración/visualización)
     void printEdges(Node *n, int height = 0) {
@@ -0,0 +1,442 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TOKENSUFFIXTREE_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TOKENSUFFIXTREE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// ======================= Suffix tree sobre tokens (alfabeto entero) =======================
+// Variante de SuffixTree cuyo texto es una secuencia de enteros de 32 bits (por ejemplo, IDs de
+// palabras) en lugar de caracteres 'A'..'Z'. Al indexar palabras, n se reduce varias veces y las
+// búsquedas de frases son exactas (no pueden empezar ni terminar a mitad de una palabra).
+
+typedef uint32_t Token;
+
+// Token terminal, cumple el rol de '$': se agrega automáticamente al final y no puede aparecer en la entrada.
+const Token TERMINAL_TOKEN = UINT32_MAX;
+// Token que nunca aparece en un texto construido con Vocabulary; se usa para palabras desconocidas.
+const Token UNKNOWN_TOKEN = UINT32_MAX - 1;
+
+// ======================= Vocabulario (tokenización por palabras) =======================
+// Asigna IDs consecutivos a las palabras (separadas por espacios en blanco).
+class Vocabulary {
+private:
+    unordered_map<string, Token> ids;
+    vector<string> words;
+
+public:
+    // ID de 'word', registrándola si es nueva.
+    Token idOf(const string &word) {
+        auto it = ids.find(word);
+        if (it != ids.end())
+            return it->second;
+        Token id = static_cast<Token>(words.size());
+        ids.emplace(word, id);
+        words.push_back(word);
+        return id;
+    }
+
+    // ID de 'word' sin registrarla; UNKNOWN_TOKEN si no está en el vocabulario.
+    Token lookup(const string &word) const {
+        auto it = ids.find(word);
+        return it != ids.end() ? it->second : UNKNOWN_TOKEN;
+    }
+
+    // Tokeniza un texto para indexarlo (registra palabras nuevas).
+    vector<Token> tokenize(const string &text) {
+        vector<Token> tokens;
+        istringstream in(text);
+        string word;
+        while (in >> word)
+            tokens.push_back(idOf(word));
+        return tokens;
+    }
+
+    // Tokeniza una frase de consulta (las palabras desconocidas se mapean a UNKNOWN_TOKEN).
+    vector<Token> encode(const string &phrase) const {
+        vector<Token> tokens;
+        istringstream in(phrase);
+        string word;
+        while (in >> word)
+            tokens.push_back(lookup(word));
+        return tokens;
+    }
+
+    // Reconstruye el texto de una secuencia de tokens, separando las palabras con un espacio.
+    string decode(const vector<Token> &tokens) const {
+        string result;
+        for (Token token: tokens) {
+            if (!result.empty())
+                result.push_back(' ');
+            result += token < words.size() ? words[token] : "?";
+        }
+        return result;
+    }
+
+    size_t size() const {
+        return words.size();
+    }
+};
+
+// ======================= Estructura de Nodo =======================
+// Igual que Node, pero los hijos se guardan en un map ordenado por token: con alfabetos de cientos de
+// miles de símbolos un arreglo por nodo es inviable, y el orden del map conserva el orden lexicográfico.
+struct TokenNode {
+    int start; // Índice de inicio del label en "tokens"
+    int *end; // Puntero al índice final del label; para hojas, se comparte leafEnd
+    int suffixIndex; // Para hojas, posición del sufijo en "tokens" (base 0); -1 en nodos internos
+    TokenNode *suffixLink; // Suffix link para la construcción con Ukkonen
+    map<Token, TokenNode *> children; // Hijos indexados por el primer token de su arista
+    int stringDepth; // Longitud (en tokens) del path label desde la raíz
+    TokenNode *parent; // Padre en el árbol (nullptr en la raíz)
+    int leafCount; // Número de hojas (ocurrencias) en el subárbol
+    int id; // Posición del nodo en preorden (permite anotar nodos en arreglos externos)
+
+    TokenNode(int start, int *end) : start(start), end(end), suffixIndex(-1), suffixLink(nullptr),
+                                     stringDepth(0), parent(nullptr), leafCount(0), id(0) {
+    }
+
+    int edgeLength() const {
+        return *end - start + 1;
+    }
+
+    bool isLeaf() const {
+        return children.empty();
+    }
+
+    TokenNode *child(Token token) const {
+        auto it = children.find(token);
+        return it != children.end() ? it->second : nullptr;
+    }
+};
+
+// Resultado de TokenSuffixTree::benchmarkIndexing(): el mismo corpus indexado por palabras y por caracteres.
+struct TokenIndexBenchmark {
+    int tokens; // Longitud del texto a nivel de palabras
+    int characters; // Longitud del texto a nivel de caracteres (palabras separadas por un espacio)
+    int tokenNodes; // Nodos de cada árbol
+    int characterNodes;
+    double tokenBuildSeconds; // Tokenización + construcción
+    double characterBuildSeconds;
+    int phrases;
+    long long tokenOccurrences; // Ocurrencias exactas de las frases (palabras completas)
+    long long characterOccurrences; // Incluye coincidencias que empiezan o terminan a mitad de palabra
+    double tokenQuerySeconds; // findAllMatches de todas las frases
+    double characterQuerySeconds;
+    double buildSpeedup; // characterBuildSeconds / tokenBuildSeconds
+    double querySpeedup; // characterQuerySeconds / tokenQuerySeconds
+};
+
+// ======================= Clase TokenSuffixTree =======================
+// Ukkonen's algorithm (algoritmos 1 a 6 del paper) sobre tokens, con las mismas consultas que
+// SuffixTree: Search, FindAllMatches, count, LRS y SUS.
+class TokenSuffixTree {
+private:
+    vector<Token> tokens; // Texto de entrada terminado en TERMINAL_TOKEN
+    TokenNode *root;
+    TokenNode *activeNode;
+    int activeLength;
+    Token activeEdge;
+    int remainingSuffixCount;
+    int leafEnd;
+    TokenNode *lastCreatedNode;
+    vector<TokenNode *> nodes; // Todos los nodos en preorden (nodes[id])
+
+public:
+    // ======================= Constructor =======================
+    // 'input' no debe contener TERMINAL_TOKEN; se agrega al final automáticamente.
+    explicit TokenSuffixTree(vector<Token> input) : tokens(std::move(input)), root(nullptr), activeNode(nullptr),
+                                                    activeLength(0), activeEdge(0), remainingSuffixCount(0),
+                                                    leafEnd(-1), lastCreatedNode(nullptr) {
+        tokens.push_back(TERMINAL_TOKEN);
+        buildSuffixTree();
+        annotateNodes();
+    }
+
+    TokenSuffixTree(const TokenSuffixTree &) = delete;
+    TokenSuffixTree &operator=(const TokenSuffixTree &) = delete;
+
+    ~TokenSuffixTree() {
+        for (TokenNode *node: nodes) {
+            if (node->end != &leafEnd)
+                delete node->end;
+            delete node;
+        }
+    }
+
+    // ======================= Algoritmo 1: Construction(S) =======================
+    void buildSuffixTree() {
+        root = new TokenNode(-1, new int(-1));
+        activeNode = root;
+        for (int i = 0; i < static_cast<int>(tokens.size()); i++)
+            extendSuffixTree(i);
+    }
+
+    // ======================= Algoritmo 2: walkDown(nextNode) =======================
+    bool walkDown(TokenNode *nextNode, int i) {
+        if (activeLength >= nextNode->edgeLength()) {
+            activeEdge = tokens[i - activeLength + nextNode->edgeLength()];
+            activeLength -= nextNode->edgeLength();
+            activeNode = nextNode;
+            return true;
+        }
+        return false;
+    }
+
+    // ======================= Algoritmo 3: createSuffixLink(node) =======================
+    void createSuffixLink(TokenNode *node, bool setToNode) {
+        if (lastCreatedNode != nullptr)
+            lastCreatedNode->suffixLink = node;
+        lastCreatedNode = setToNode ? node : nullptr;
+    }
+
+    // ======================= Algoritmo 4: splitEdge(nextNode, activeLength) =======================
+    TokenNode *splitEdge(TokenNode *nextNode, int currentActiveLength) {
+        int splitPosition = nextNode->start + currentActiveLength - 1;
+        TokenNode *splitNode = new TokenNode(nextNode->start, new int(splitPosition));
+        activeNode->children[activeEdge] = splitNode;
+        splitNode->children[tokens[splitPosition + 1]] = nextNode;
+        nextNode->start = splitPosition + 1;
+        return splitNode;
+    }
+
+    // ======================= Algoritmo 5: extendSuffixTree(i) =======================
+    void extendSuffixTree(int i) {
+        leafEnd = leafEnd + 1;
+        remainingSuffixCount++;
+        lastCreatedNode = nullptr;
+        while (remainingSuffixCount > 0) {
+            if (activeLength == 0)
+                activeEdge = tokens[i];
+            TokenNode *nextNode = activeNode->child(activeEdge);
+            if (nextNode == nullptr) {
+                // [PAPER: Regla 2] Nueva hoja
+                activeNode->children[activeEdge] = new TokenNode(i, &leafEnd);
+                createSuffixLink(activeNode, false);
+            } else {
+                if (walkDown(nextNode, i))
+                    continue;
+                if (tokens[nextNode->start + activeLength] == tokens[i]) {
+                    // [PAPER: Regla 3] El sufijo ya está implícito en el árbol
+                    activeLength++;
+                    if (lastCreatedNode != nullptr)
+                        lastCreatedNode->suffixLink = activeNode;
+                    break;
+                }
+                TokenNode *splitNode = splitEdge(nextNode, activeLength);
+                splitNode->children[tokens[i]] = new TokenNode(i, &leafEnd);
+                createSuffixLink(splitNode, true);
+            }
+            remainingSuffixCount--;
+            // ======================= Algoritmo 6: setActivePoint(i) =======================
+            if (activeNode == root && activeLength > 0) {
+                activeLength--;
+                activeEdge = tokens[i - remainingSuffixCount + 1];
+            } else if (activeNode != root) {
+                activeNode = activeNode->suffixLink != nullptr ? activeNode->suffixLink : root;
+            }
+        }
+    }
+
+    // [EXTRA] Recorrido iterativo (preorden) que asigna id, parent, stringDepth, suffixIndex y leafCount.
+    // Es iterativo porque con textos repetitivos la profundidad en nodos puede ser del orden de n.
+    void annotateNodes() {
+        nodes.clear();
+        vector<TokenNode *> stack = {root};
+        while (!stack.empty()) {
+            TokenNode *node = stack.back();
+            stack.pop_back();
+            node->id = static_cast<int>(nodes.size());
+            nodes.push_back(node);
+            // Se apilan en orden inverso para que el preorden respete el orden lexicográfico.
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                TokenNode *child = it->second;
+                child->parent = node;
+                child->stringDepth = node->stringDepth + child->edgeLength();
+                stack.push_back(child);
+            }
+        }
+        for (size_t k = nodes.size(); k-- > 0;) {
+            TokenNode *node = nodes[k];
+            if (node->isLeaf()) {
+                node->suffixIndex = static_cast<int>(tokens.size()) - node->stringDepth;
+                node->leafCount = 1;
+            } else {
+                node->leafCount = 0;
+                for (const auto &entry: node->children)
+                    node->leafCount += entry.second->leafCount;
+            }
+        }
+    }
+
+    // ======================= Algoritmo 8: Search(P) =======================
+    // Retorna el nodo más alto cuyo path label tiene a 'pattern' como prefijo (nullptr si no aparece).
+    TokenNode *locate(const vector<Token> &pattern) const {
+        TokenNode *v = root;
+        size_t pos = 0;
+        while (pos < pattern.size()) {
+            TokenNode *child = v->child(pattern[pos]);
+            if (child == nullptr)
+                return nullptr;
+            size_t len = min(static_cast<size_t>(child->edgeLength()), pattern.size() - pos);
+            for (size_t i = 0; i < len; i++) {
+                if (tokens[child->start + i] != pattern[pos + i])
+                    return nullptr;
+            }
+            pos += len;
+            v = child;
+        }
+        return v;
+    }
+
+    bool search(const vector<Token> &pattern) const {
+        return locate(pattern) != nullptr;
+    }
+
+    // ======================= Algoritmo 9: FindAllMatches(P) =======================
+    // Posiciones (en tokens, base 0, ordenadas) de todas las ocurrencias de 'pattern'.
+    vector<int> findAllMatches(const vector<Token> &pattern) const {
+        vector<int> matches;
+        TokenNode *v = locate(pattern);
+        if (v == nullptr)
+            return matches;
+        collectLeaves(v, matches);
+        sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    // [EXTRA] Número de ocurrencias de 'pattern' en O(|pattern| · log Σ).
+    int count(const vector<Token> &pattern) const {
+        TokenNode *v = locate(pattern);
+        return v != nullptr ? v->leafCount : 0;
+    }
+
+    // [EXTRA] Agrega a 'out' los suffixIndex de las hojas bajo 'node' (DFS iterativa).
+    void collectLeaves(TokenNode *node, vector<int> &out) const {
+        vector<TokenNode *> stack = {node};
+        while (!stack.empty()) {
+            TokenNode *current = stack.back();
+            stack.pop_back();
+            if (current->isLeaf())
+                out.push_back(current->suffixIndex);
+            for (const auto &entry: current->children)
+                stack.push_back(entry.second);
+        }
+    }
+
+    // ======================= Algoritmo 10: Longest Repeated Substring (LRS) =======================
+    // Nodo interno más profundo (aparece al menos dos veces). Se recorre el arreglo de nodos sin
+    // copiar path labels; el resultado se extrae una sola vez al final.
+    vector<Token> longestRepeatedSubstring() const {
+        const TokenNode *best = root;
+        for (const TokenNode *node: nodes) {
+            if (!node->isLeaf() && node->stringDepth > best->stringDepth)
+                best = node;
+        }
+        return label(best, best->stringDepth);
+    }
+
+    // ======================= Algoritmo 11: Shortest Unique Substring (SUS) =======================
+    // Un substring aparece una sola vez si su locus está en la arista de una hoja; el más corto de
+    // esos es label(padre) + primer token de la arista de la hoja (sin usar TERMINAL_TOKEN).
+    vector<Token> shortestUniqueSubstring() const {
+        const TokenNode *best = nullptr;
+        for (const TokenNode *node: nodes) {
+            if (node == root || !node->isLeaf() || tokens[node->start] == TERMINAL_TOKEN)
+                continue;
+            if (best == nullptr || node->parent->stringDepth < best->parent->stringDepth)
+                best = node;
+        }
+        if (best == nullptr)
+            return {};
+        return label(best, best->parent->stringDepth + 1);
+    }
+
+    // ======================= [EXTRA] Accesores =======================
+    // Primeros 'length' tokens del path label de 'node'.
+    vector<Token> label(const TokenNode *node, int length) const {
+        int begin = labelStart(node);
+        return vector<Token>(tokens.begin() + begin, tokens.begin() + begin + length);
+    }
+
+    // Inicio en "tokens" de una ocurrencia del path label de 'node' (termina en *node->end).
+    int labelStart(const TokenNode *node) const {
+        return node == root ? 0 : *node->end - node->stringDepth + 1;
+    }
+
+    TokenNode *getRoot() const {
+        return root;
+    }
+
+    // Nodos en preorden lexicográfico; getNodes()[id] es el nodo con ese id.
+    const vector<TokenNode *> &getNodes() const {
+        return nodes;
+    }
+
+    // Texto indexado, incluyendo el TERMINAL_TOKEN final.
+    const vector<Token> &getTokens() const {
+        return tokens;
+    }
+
+    // ======================= [EXTRA] Benchmark: palabras vs caracteres =======================
+    // Indexa 'corpus' dos veces con el mismo algoritmo: por palabras (Vocabulary) y por caracteres (cada
+    // byte es un token, con las palabras separadas por un único espacio para que ambos textos sean el
+    // mismo), y busca cada frase de 'phrases' con findAllMatches en los dos árboles.
+    static TokenIndexBenchmark benchmarkIndexing(const string &corpus, const vector<string> &phrases) {
+        TokenIndexBenchmark report{};
+        report.phrases = static_cast<int>(phrases.size());
+        auto toCharacters = [](const string &text) {
+            vector<Token> characters;
+            istringstream in(text);
+            string word;
+            while (in >> word) {
+                if (!characters.empty())
+                    characters.push_back(' ');
+                characters.insert(characters.end(), word.begin(), word.end());
+            }
+            for (Token &c: characters)
+                c &= 0xFF; // char con signo -> byte
+            return characters;
+        };
+
+        auto begin = chrono::steady_clock::now();
+        Vocabulary vocabulary;
+        TokenSuffixTree wordTree(vocabulary.tokenize(corpus));
+        report.tokenBuildSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        begin = chrono::steady_clock::now();
+        TokenSuffixTree characterTree(toCharacters(corpus));
+        report.characterBuildSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        report.tokens = static_cast<int>(wordTree.tokens.size()) - 1;
+        report.characters = static_cast<int>(characterTree.tokens.size()) - 1;
+        report.tokenNodes = static_cast<int>(wordTree.nodes.size());
+        report.characterNodes = static_cast<int>(characterTree.nodes.size());
+
+        // Las frases se codifican antes de medir (la codificación no depende del índice).
+        vector<vector<Token> > wordPatterns, characterPatterns;
+        for (const string &phrase: phrases) {
+            wordPatterns.push_back(vocabulary.encode(phrase));
+            characterPatterns.push_back(toCharacters(phrase));
+        }
+        begin = chrono::steady_clock::now();
+        for (const vector<Token> &pattern: wordPatterns)
+            report.tokenOccurrences += static_cast<long long>(wordTree.findAllMatches(pattern).size());
+        report.tokenQuerySeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        begin = chrono::steady_clock::now();
+        for (const vector<Token> &pattern: characterPatterns)
+            report.characterOccurrences += static_cast<long long>(characterTree.findAllMatches(pattern).size());
+        report.characterQuerySeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        report.buildSpeedup = report.tokenBuildSeconds > 0 ? report.characterBuildSeconds / report.tokenBuildSeconds : 0;
+        report.querySpeedup = report.tokenQuerySeconds > 0 ? report.characterQuerySeconds / report.tokenQuerySeconds : 0;
+        return report;
+    }
+};
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TOKENSUFFIXTREE_H
@@ -1,21 +1,14 @@
 #include "SuffixTree.h"
 
-void capitalizeString(string &s) {
-    for (char &i: s) {
-        if (i >= 'a' && i <= 'z')
-            i = i - 'a' + 'A';
-    }
-}
-
 int main() {
     string input;
     cout << "Suffix Tree Demo\nConstruccion:\nIngrese la cadena a construir: ";
     cin >> input;
-    capitalizeString(input);
     input.push_back('$');
 
     // Algorithm 1: Construction
-    SuffixTree st(input);
+    // El árbol ignora mayúsculas/minúsculas al vuelo (sin copias del texto ni de los patrones).
+    SuffixTree st(std::move(input), Normalization::caseFolding());
 
     // Algorithm to print the tree
     st.printTree();
@@ -24,7 +17,6 @@ int main() {
     string pattern;
     cout << "\nString Matching:\nIngrese la cadena a buscar: ";
     cin >> pattern;
-    capitalizeString(pattern);
     if (st.search(pattern)) {
         cout << "El patron '" << pattern << "' fue encontrado. \n";
     } else {
@@ -35,7 +27,6 @@ int main() {
     string substring;
     cout << "\nFind all occurrences:\nIngrese el patron a buscar: ";
     cin >> substring;
-    capitalizeString(substring);
     vector<int> positions = st.findAllMatches(substring);
     if (positions.empty()) {
         cout << "El patron '" << substring << "' no se encontro en el texto.\n";
@@ -0,0 +1,42 @@
+#include "BruteForce.h"
+#include "Check.h"
+#include "SuffixTree.h"
+
+// Extiende un patrón a izquierda y derecha en orden aleatorio desde un punto medio y compara cada paso
+// (encontrado, ocurrencias y offset) con la búsqueda por fuerza bruta, con y sin Weiner links precalculados.
+static void testRandomExtensions() {
+    mt19937 random(78);
+    for (int iteration = 0; iteration < 1000; iteration++) {
+        const int n = 1 + static_cast<int>(random() % 50);
+        const int sigma = 1 + static_cast<int>(random() % 4);
+        const string text = randomText(random, n, sigma);
+        SuffixTree tree(text + "$");
+        if (iteration % 2 == 1)
+            tree.buildWeinerLinks();
+        for (int q = 0; q < 30; q++) {
+            const int length = 1 + static_cast<int>(random() % 6);
+            string pattern = random() % 3 == 0 ? randomText(random, length, sigma)
+                                               : text.substr(random() % n, length);
+            const int middle = static_cast<int>(random() % (pattern.size() + 1));
+            int lo = middle, hi = middle;
+            Locus locus = tree.rootLocus();
+            while (lo > 0 || hi < static_cast<int>(pattern.size())) {
+                const bool left = lo > 0 && (hi == static_cast<int>(pattern.size()) || random() % 2 == 0);
+                locus = left ? tree.extendLeft(locus, pattern[--lo]) : tree.extendRight(locus, pattern[hi++]);
+                const string current = pattern.substr(lo, hi - lo);
+                const vector<int> expected = bruteFind(text, current);
+                CHECK(locus.found() == !expected.empty());
+                if (!locus.found())
+                    break;
+                CHECK(tree.locusOccurrences(locus) == expected);
+                CHECK(text.compare(tree.locusOffset(locus), current.size(), current) == 0);
+            }
+            CHECK(tree.locate(pattern).found() == tree.search(pattern));
+        }
+    }
+}
+
+int main() {
+    testRandomExtensions();
+    return checkResult();
+}
@@ -0,0 +1,29 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TESTS_BRUTEFORCE_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TESTS_BRUTEFORCE_H
+
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+// ======================= Referencias por fuerza bruta para los tests =======================
+
+// Texto aleatorio de 'length' caracteres entre 'A' y 'A' + sigma - 1 (sin el '$').
+inline string randomText(mt19937 &random, int length, int sigma) {
+    string text;
+    for (int i = 0; i < length; i++)
+        text += static_cast<char>('A' + random() % sigma);
+    return text;
+}
+
+// Posiciones (ordenadas) de las ocurrencias de 'pattern' en 'text'.
+inline vector<int> bruteFind(const string &text, const string &pattern) {
+    vector<int> matches;
+    for (size_t p = 0; p + pattern.size() <= text.size(); p++) {
+        if (text.compare(p, pattern.size(), pattern) == 0)
+            matches.push_back(static_cast<int>(p));
+    }
+    return matches;
+}
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TESTS_BRUTEFORCE_H
@@ -0,0 +1,29 @@
+#ifndef ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TESTS_CHECK_H
+#define ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TESTS_CHECK_H
+
+#include <cstdio>
+
+// ======================= Aserciones de los tests =======================
+// Cada test es un ejecutable registrado en ctest: CHECK reporta la condición que falló y sigue, y
+// main retorna checkResult() (1 si alguna falló).
+
+inline int &checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: falló CHECK(%s)\n", __FILE__, __LINE__, #condition); \
+            checkFailures()++; \
+        } \
+    } while (0)
+
+inline int checkResult() {
+    if (checkFailures() > 0)
+        std::fprintf(stderr, "%d verificaciones fallaron\n", checkFailures());
+    return checkFailures() == 0 ? 0 : 1;
+}
+
+#endif //ALGORITHMS_AND_DATA_STRUCTURES_PROJECT_TESTS_CHECK_H
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include "BruteForce.h"
+#include "Check.h"
+#include "SuffixTree.h"
+
+static const string CHECKPOINT_PATH = "CheckpointTest.bin";
+static const string DAMAGED_PATH = "CheckpointTest.damaged.bin";
+
+static string readFile(const string &path) {
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+static void writeFile(const string &path, const string &contents) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(contents.data(), static_cast<streamsize>(contents.size()));
+}
+
+// El árbol reanudado responde igual que la fuerza bruta y que el árbol construido de una vez.
+static void checkEquivalent(SuffixTree &tree, const string &text, mt19937 &random) {
+    for (int q = 0; q < 30; q++) {
+        const string pattern = randomText(random, 1 + static_cast<int>(random() % 4), 2);
+        vector<int> matches = tree.findAllMatches(pattern);
+        sort(matches.begin(), matches.end());
+        CHECK(matches == bruteFind(text, pattern));
+    }
+    CHECK(tree.distinctSubstringCount() == SuffixTree(text).distinctSubstringCount());
+}
+
+// Se interrumpe la construcción guardando cada 'interval' fases y se reanuda desde el último checkpoint.
+static void testResume() {
+    mt19937 random(89);
+    for (int iteration = 0; iteration < 200; iteration++) {
+        const string text = randomText(random, 1 + static_cast<int>(random() % 200),
+                                       1 + static_cast<int>(random() % 4)) + "$";
+        const int n = static_cast<int>(text.size());
+        const int interval = 1 + static_cast<int>(random() % 20);
+        { SuffixTree partial(text, CheckpointOptions(CHECKPOINT_PATH, interval, false, false)); }
+        SuffixTree resumed(text, CheckpointOptions(CHECKPOINT_PATH, interval, true, true));
+        CHECK(resumed.getResumedPhase() == (n - 1) / interval * interval);
+        checkEquivalent(resumed, text, random);
+        CHECK(!ifstream(CHECKPOINT_PATH).good()); // removeOnSuccess
+    }
+}
+
+// Un checkpoint truncado o con un byte alterado se descarta y la construcción empieza de cero.
+static void testDamagedFiles() {
+    mt19937 random(890);
+    for (int iteration = 0; iteration < 100; iteration++) {
+        const string text = randomText(random, 20 + static_cast<int>(random() % 200), 3) + "$";
+        { SuffixTree partial(text, CheckpointOptions(CHECKPOINT_PATH, 8, false, false)); }
+        const string contents = readFile(CHECKPOINT_PATH);
+        CHECK(!contents.empty());
+        if (contents.empty())
+            continue;
+
+        writeFile(DAMAGED_PATH, contents.substr(0, random() % contents.size()));
+        SuffixTree truncated(text, CheckpointOptions(DAMAGED_PATH, 0, true, true));
+        CHECK(truncated.getResumedPhase() == 0);
+        checkEquivalent(truncated, text, random);
+
+        string flipped = contents;
+        flipped[random() % flipped.size()] ^= static_cast<char>(1 + random() % 255);
+        writeFile(DAMAGED_PATH, flipped);
+        SuffixTree damaged(text, CheckpointOptions(DAMAGED_PATH, 0, true, true));
+        CHECK(damaged.getResumedPhase() == 0);
+        checkEquivalent(damaged, text, random);
+    }
+    remove(CHECKPOINT_PATH.c_str());
+}
+
+// Un checkpoint de otro texto o de otra normalización no se reanuda.
+static void testMismatch() {
+    mt19937 random(8900);
+    const string text = randomText(random, 100, 3) + "$";
+    { SuffixTree partial(text, CheckpointOptions(CHECKPOINT_PATH, 7, false, false)); }
+    string other = text;
+    other[3] = other[3] == 'A' ? 'B' : 'A';
+    SuffixTree otherText(other, CheckpointOptions(CHECKPOINT_PATH, 0, true, false));
+    CHECK(otherText.getResumedPhase() == 0);
+
+    Normalization otherNormalization = Normalization::caseFolding();
+    otherNormalization.map('C', 'A');
+    SuffixTree normalized(text, CheckpointOptions(CHECKPOINT_PATH, 0, true, false), otherNormalization);
+    CHECK(normalized.getResumedPhase() == 0);
+
+    SuffixTree resumed(text, CheckpointOptions(CHECKPOINT_PATH, 0, true, true));
+    CHECK(resumed.getResumedPhase() > 0);
+    checkEquivalent(resumed, text, random);
+}
+
+int main() {
+    testResume();
+    testDamagedFiles();
+    testMismatch();
+    return checkResult();
+}
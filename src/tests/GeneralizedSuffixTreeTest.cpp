@@ -0,0 +1,131 @@
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include "BruteForce.h"
+#include "Check.h"
+#include "GeneralizedSuffixTree.h"
+
+static vector<string> randomDocuments(mt19937 &random, int count, int maxLength) {
+    vector<string> documents;
+    for (int d = 0; d < count; d++)
+        documents.push_back(randomText(random, static_cast<int>(random() % (maxLength + 1)), 3));
+    return documents;
+}
+
+// Frases del cross-parsing de s respecto a t por fuerza bruta.
+static int bruteCrossParse(const string &s, const string &t) {
+    int phrases = 0;
+    for (size_t p = 0; p < s.size();) {
+        size_t matched = 0;
+        while (p + matched < s.size() && t.find(s.substr(p, matched + 1)) != string::npos)
+            matched++;
+        phrases++;
+        p += max<size_t>(matched, 1);
+    }
+    return phrases;
+}
+
+// Cada nodo interno (salvo la raíz) contiene exactamente los documentos donde aparece su path label.
+static void checkDocumentSets(GeneralizedSuffixTree &tree, const vector<string> &documents) {
+    const vector<Token> &tokens = tree.getTree().getTokens();
+    tree.forEachDocumentSet([&](const TokenNode *node, const DocumentSetView &set) {
+        if (node->isLeaf() || node->parent == nullptr)
+            return;
+        const int start = tree.getTree().labelStart(node);
+        string label;
+        for (int k = 0; k < node->stringDepth; k++)
+            label += static_cast<char>(tokens[start + k]);
+        vector<int> expected;
+        for (int d = 0; d < static_cast<int>(documents.size()); d++) {
+            if (documents[d].find(label) != string::npos)
+                expected.push_back(d);
+        }
+        CHECK(set.members() == expected);
+        CHECK(set.size == static_cast<int>(expected.size()));
+    });
+}
+
+// crossParse (y containsDocument, en el que se apoya) contra la fuerza bruta, con bitsets y con
+// conjuntos dispersos (más de DENSE_DOCUMENT_LIMIT documentos).
+static void testCrossParse() {
+    mt19937 random(97);
+    for (int iteration = 0; iteration < 40; iteration++) {
+        const bool sparse = iteration % 4 == 3;
+        const int count = sparse ? DENSE_DOCUMENT_LIMIT + 1 + static_cast<int>(random() % 200)
+                                 : 1 + static_cast<int>(random() % 40);
+        const vector<string> documents = randomDocuments(random, count, 15);
+        GeneralizedSuffixTree tree(documents);
+        checkDocumentSets(tree, documents);
+        for (int q = 0; q < 300; q++) {
+            const int i = static_cast<int>(random() % count), j = static_cast<int>(random() % count);
+            CHECK(tree.crossParse(i, j) == bruteCrossParse(documents[i], documents[j]));
+        }
+    }
+}
+
+// Los grupos de findNearDuplicates son las componentes conexas de "comparten un substring de longitud
+// minLength", en ambos modos.
+static void testNearDuplicateClusters() {
+    mt19937 random(970);
+    for (int iteration = 0; iteration < 30; iteration++) {
+        const bool sparse = iteration % 5 == 4;
+        const int count = sparse ? DENSE_DOCUMENT_LIMIT + 1 + static_cast<int>(random() % 100)
+                                 : 2 + static_cast<int>(random() % 70);
+        const int minLength = 3 + static_cast<int>(random() % 4);
+        const vector<string> documents = randomDocuments(random, count, 15);
+        GeneralizedSuffixTree tree(documents);
+        stringstream report;
+        NearDuplicateSummary summary = tree.findNearDuplicates(minLength, report);
+
+        vector<int> parent(count);
+        for (int d = 0; d < count; d++)
+            parent[d] = d;
+        function<int(int)> find = [&](int x) { return parent[x] == x ? x : parent[x] = find(parent[x]); };
+        for (int i = 0; i < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                for (size_t a = 0; a + minLength <= documents[i].size(); a++) {
+                    if (documents[j].find(documents[i].substr(a, minLength)) != string::npos) {
+                        parent[find(i)] = find(j);
+                        break;
+                    }
+                }
+            }
+        }
+        map<int, set<int> > components;
+        for (int d = 0; d < count; d++)
+            components[find(d)].insert(d);
+        set<set<int> > expected;
+        for (const auto &component: components) {
+            if (component.second.size() >= 2)
+                expected.insert(component.second);
+        }
+
+        set<set<int> > clusters;
+        long long repeats = 0;
+        string line;
+        while (getline(report, line)) {
+            if (line.find("\"cluster\"") == string::npos) {
+                repeats++;
+                continue;
+            }
+            const size_t first = line.find("\"documents\":[") + 13, last = line.find(']', first);
+            stringstream members(line.substr(first, last - first));
+            set<int> cluster;
+            string member;
+            while (getline(members, member, ','))
+                cluster.insert(stoi(member));
+            clusters.insert(cluster);
+        }
+        CHECK(clusters == expected);
+        CHECK(summary.clusters == static_cast<int>(expected.size()));
+        CHECK(summary.repeats == repeats);
+    }
+}
+
+int main() {
+    testCrossParse();
+    testNearDuplicateClusters();
+    return checkResult();
+}
@@ -0,0 +1,99 @@
+#include <random>
+#include <sstream>
+#include "Check.h"
+#include "GrammarCompressor.h"
+
+// Razón de compresión con el tamaño serializado (el mismo que reporta benchmark()).
+static double ratioOf(const string &text, const StraightLineProgram &program) {
+    return static_cast<double>(text.size()) / program.serializedSize();
+}
+
+static string repeat(const string &unit, int copies) {
+    string text;
+    for (int k = 0; k < copies; k++)
+        text += unit;
+    return text;
+}
+
+// decode, access, extract y write/read contra el texto original en textos aleatorios chicos.
+static void testRoundTrip() {
+    mt19937 random(88);
+    for (int iteration = 0; iteration < 300; iteration++) {
+        const int n = static_cast<int>(random() % 300);
+        const int sigma = 1 + static_cast<int>(random() % 4);
+        string text;
+        for (int i = 0; i < n; i++)
+            text += static_cast<char>((random() % 2 ? 'a' : 200) + random() % sigma);
+        if (iteration % 3 == 0)
+            text = repeat(text.substr(0, 20) + "x", 10);
+        StraightLineProgram program = GrammarCompressor::compress(text, 2 + static_cast<int>(random() % 3));
+        CHECK(program.decode() == text);
+        CHECK(program.length() == static_cast<long long>(text.size()));
+        for (size_t i = 0; i < text.size(); i++)
+            CHECK(program.access(static_cast<long long>(i)) == text[i]);
+        for (int q = 0; q < 20 && !text.empty(); q++) {
+            const long long from = random() % text.size(), count = random() % (text.size() + 3);
+            CHECK(program.extract(from, count) == text.substr(from, count));
+        }
+        stringstream file;
+        program.write(file);
+        CHECK(static_cast<long long>(file.str().size()) == program.serializedSize());
+        StraightLineProgram read = StraightLineProgram::read(file);
+        CHECK(file && read.decode() == text);
+    }
+}
+
+// Un archivo truncado deja el stream en error en lugar de leer símbolos inválidos.
+static void testTruncatedRead() {
+    StraightLineProgram program = GrammarCompressor::compress(repeat("abcabd", 50));
+    stringstream file;
+    program.write(file);
+    string bytes = file.str();
+    stringstream truncated(bytes.substr(0, bytes.size() / 2));
+    StraightLineProgram::read(truncated);
+    CHECK(!truncated);
+}
+
+// Textos periódicos: las repeticiones más largas se solapan consigo mismas, pero las cortas deben
+// reemplazarse igual.
+static void testPeriodicInput() {
+    const string fox = "the quick brown fox jumps ";
+    for (const auto &test: vector<pair<string, double> >{{repeat(fox, 2000), 50.0},
+                                                          {repeat("abcdefgh", 200), 5.0},
+                                                          {repeat(fox, 20), 2.0},
+                                                          {string(100000, 'a'), 100.0}}) {
+        int rounds = 0;
+        StraightLineProgram program = GrammarCompressor::compress(test.first, 2, 64, &rounds);
+        CHECK(program.ruleCount() > 0);
+        CHECK(ratioOf(test.first, program) > test.second);
+        CHECK(program.decode() == test.first);
+    }
+}
+
+// Un texto incompresible no crece más que la cabecera.
+static void testRandomInput() {
+    mt19937 random(1);
+    string text(200000, '\0');
+    for (char &c: text)
+        c = static_cast<char>(random());
+    StraightLineProgram program = GrammarCompressor::compress(text);
+    CHECK(ratioOf(text, program) > 0.99);
+    CHECK(program.decode() == text);
+}
+
+// benchmark() verifica que el programa descomprima el texto.
+static void testBenchmark() {
+    CompressionReport report = GrammarCompressor::benchmarkPeriodic("the quick brown fox jumps ", 2000, 1000);
+    CHECK(report.roundTrip);
+    CHECK(report.rules > 0 && report.ratio > 50.0);
+    CHECK(report.originalBytes == 52000);
+}
+
+int main() {
+    testRoundTrip();
+    testTruncatedRead();
+    testPeriodicInput();
+    testRandomInput();
+    testBenchmark();
+    return checkResult();
+}
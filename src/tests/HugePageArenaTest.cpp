@@ -0,0 +1,72 @@
+#include "Check.h"
+#include "SuffixTree.h"
+
+// Alineación, máscara de direcciones y reuso de la arena después de release().
+static void testAllocation(bool hugePages) {
+    HugePageArena arena(hugePages, ChildRef::POINTER_MASK);
+    for (int k = 0; k < 200000; k++) {
+        const size_t alignment = size_t(1) << (k % 7);
+        void *memory = arena.allocate(1 + k % 300, alignment);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+        CHECK(address % alignment == 0);
+        CHECK((address & ~ChildRef::POINTER_MASK) == 0);
+    }
+    CHECK(arena.blockCount() > 1);
+    CHECK(arena.bytesReserved() > 0);
+    arena.release();
+    CHECK(arena.blockCount() == 0 && arena.bytesReserved() == 0);
+    int *value = arena.create<int>(7);
+    CHECK(*value == 7);
+}
+
+// Un árbol chico reserva un solo bloque chico; uno grande pasa a bloques de huge pages.
+static void testBlockGrowth() {
+    SuffixTree small("BANANA$");
+    CHECK(small.nodeBytesReserved() < (size_t(2) << 20));
+    string text;
+    for (int i = 0; i < 200000; i++)
+        text += static_cast<char>('A' + (i * 7 + i / 11) % 6);
+    text += '$';
+    SuffixTree large(text);
+    CHECK(large.nodeBytesReserved() >= (size_t(2) << 20));
+}
+
+// El árbol responde igual con y sin huge pages.
+static void testTreeWithAndWithoutHugePages() {
+    string text;
+    for (int i = 0; i < 50000; i++)
+        text += static_cast<char>('A' + (i * 7 + i / 13) % 5);
+    text += '$';
+    SuffixTree::hugePagesEnabled = false;
+    SuffixTree plain(text);
+    SuffixTree::hugePagesEnabled = true;
+    SuffixTree huge(text);
+    for (const string &pattern: {string("ABC"), string("EAB"), string("AAAA"), text.substr(1000, 40)})
+        CHECK(plain.findAllMatches(pattern) == huge.findAllMatches(pattern));
+    CHECK(plain.nodeBytesReserved() > 0 && huge.nodeBytesReserved() > 0);
+    CHECK(plain.hugePageBlocks() == 0);
+}
+
+// benchmarkHugePages restaura hugePagesEnabled y marca los contadores de TLB que no están disponibles.
+static void testBenchmark() {
+    string text;
+    for (int i = 0; i < 20000; i++)
+        text += static_cast<char>('A' + (i * 13 + i / 7) % 4);
+    text += '$';
+    SuffixTree::hugePagesEnabled = true;
+    HugePageBenchmark report = SuffixTree::benchmarkHugePages(text, {"ABCD", "DDDD", text.substr(500, 30)}, 2);
+    CHECK(SuffixTree::hugePagesEnabled);
+    CHECK(report.textLength == 20001 && report.patterns == 3 && report.searches == 6);
+    CHECK(report.hugeBuildSeconds > 0 && report.plainBuildSeconds > 0);
+    if (!report.tlbCountersAvailable)
+        CHECK(report.hugeBuildTlbMisses == -1 && report.plainSearchTlbMisses == -1);
+}
+
+int main() {
+    testAllocation(true);
+    testAllocation(false);
+    testBlockGrowth();
+    testTreeWithAndWithoutHugePages();
+    testBenchmark();
+    return checkResult();
+}
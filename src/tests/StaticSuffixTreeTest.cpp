@@ -0,0 +1,44 @@
+#include <algorithm>
+#include "BruteForce.h"
+#include "Check.h"
+#include "StaticSuffixTree.h"
+
+// Consultas en tiempo de compilación.
+constexpr StaticSuffixTree banana("BANANA$");
+static_assert(banana.search("NAN") && !banana.search("NAB"));
+static_assert(banana.count("ANA") == 2 && banana.count("") == 7);
+
+// Con menos capacidad que ocurrencias quedan las menores posiciones, ordenadas.
+constexpr int firstTwoMatches() {
+    int out[2]{};
+    int total = banana.findAllMatches("A", out, 2);
+    return total * 100 + out[0] * 10 + out[1];
+}
+static_assert(firstTwoMatches() == 313);
+
+static void testAgainstBruteForce() {
+    static constexpr StaticSuffixTree tree("ABAABABBABAAABABABBBABAAABABBABAABBABABBABAAABBBABABABAAABABBBAAABABAB$");
+    const string text(tree.getText().substr(0, tree.getText().size() - 1));
+    mt19937 random(92);
+    for (int q = 0; q < 2000; q++) {
+        string pattern;
+        const int length = 1 + static_cast<int>(random() % 5);
+        for (int i = 0; i < length; i++)
+            pattern += static_cast<char>('A' + random() % 3);
+        const vector<int> expected = bruteFind(text, pattern);
+        CHECK(tree.findAllMatches(pattern) == expected);
+        CHECK(tree.count(pattern) == static_cast<int>(expected.size()));
+        CHECK(tree.search(pattern) == !expected.empty());
+        // Capacidad acotada: las 'capacity' menores posiciones.
+        const int capacity = static_cast<int>(random() % 5);
+        int out[5]{};
+        CHECK(tree.findAllMatches(pattern, out, capacity) == static_cast<int>(expected.size()));
+        const int kept = min(capacity, static_cast<int>(expected.size()));
+        CHECK(equal(out, out + kept, expected.begin()));
+    }
+}
+
+int main() {
+    testAgainstBruteForce();
+    return checkResult();
+}
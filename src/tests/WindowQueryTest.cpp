@@ -0,0 +1,78 @@
+#include <map>
+#include <random>
+#include "Check.h"
+#include "SuffixTree.h"
+
+// Ocurrencias (solapadas) de cada substring de longitud l dentro de window.
+static map<string, int> substringCounts(const string &window, int l) {
+    map<string, int> counts;
+    for (int p = 0; p + l <= static_cast<int>(window.size()); p++)
+        counts[window.substr(p, l)]++;
+    return counts;
+}
+
+// Longitudes de LRS y SUS por fuerza bruta.
+static int bruteLrs(const string &window) {
+    int best = 0;
+    for (int l = 1; l < static_cast<int>(window.size()); l++) {
+        for (const auto &entry: substringCounts(window, l)) {
+            if (entry.second >= 2)
+                best = l;
+        }
+    }
+    return best;
+}
+
+static int bruteSus(const string &window) {
+    for (int l = 1; l <= static_cast<int>(window.size()); l++) {
+        for (const auto &entry: substringCounts(window, l)) {
+            if (entry.second == 1)
+                return l;
+        }
+    }
+    return static_cast<int>(window.size());
+}
+
+static void testAgainstBruteForce() {
+    mt19937 random(94);
+    for (int iteration = 0; iteration < 200; iteration++) {
+        const int n = 1 + static_cast<int>(random() % 60);
+        const int sigma = 1 + static_cast<int>(random() % 4);
+        string text;
+        for (int i = 0; i < n; i++)
+            text += static_cast<char>('A' + random() % sigma);
+        SuffixTree tree(text + "$");
+        for (int q = 0; q < 20; q++) {
+            int a = static_cast<int>(random() % n), b = static_cast<int>(random() % n);
+            if (a > b)
+                swap(a, b);
+            const string window = text.substr(a, b - a + 1);
+            const string lrs = tree.longestRepeatedSubstring(a, b);
+            const string sus = tree.shortestUniqueSubstring(a, b);
+            CHECK(static_cast<int>(lrs.size()) == bruteLrs(window));
+            CHECK(static_cast<int>(sus.size()) == bruteSus(window));
+            CHECK(substringCounts(window, static_cast<int>(lrs.size()))[lrs] >= 2 || lrs.empty());
+            CHECK(substringCounts(window, static_cast<int>(sus.size()))[sus] == 1);
+        }
+        CHECK(tree.longestRepeatedSubstring(-1, 0).empty());
+        CHECK(tree.shortestUniqueSubstring(0, n).empty());
+    }
+}
+
+// El benchmark compara con el árbol reconstruido de cada ventana: las longitudes deben coincidir.
+static void testBenchmark() {
+    mt19937 random(7);
+    string text;
+    for (int i = 0; i < 20000; i++)
+        text += static_cast<char>('A' + random() % 4);
+    SuffixTree tree(text + "$");
+    WindowQueryBenchmark report = tree.benchmarkWindowQueries(300, 50);
+    CHECK(report.mismatches == 0);
+    CHECK(report.queries == 50 && report.windowLength == 300);
+}
+
+int main() {
+    testAgainstBruteForce();
+    testBenchmark();
+    return checkResult();
+}